@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+
+"""
+Scaling benchmark for the NUMA-aware Monte Carlo mode (`-Q`).
+
+Runs the same workload with increasing numbers of threads, for each thread-affinity policy, with
+and without huge pages, and prints the median wall-clock time, throughput, speedup and parallel
+efficiency of each configuration. On a multi-socket machine, the `scatter` policy spreads threads
+across sockets from the start, while `compact` fills one socket first, so comparing the two shows
+the cost and the benefit of crossing the interconnect.
+"""
+
+import argparse
+import glob
+import os
+import statistics
+import subprocess
+import sys
+
+
+def getNumberOfNumaNodes():
+	"""Number of NUMA nodes, as reported by sysfs (1 if unavailable)."""
+	return max(1, len(glob.glob("/sys/devices/system/node/node[0-9]*")))
+
+
+def getThreadCounts(maxNumberOfThreads):
+	"""Powers of two up to, and including, `maxNumberOfThreads`."""
+	counts = []
+	count = 1
+
+	while count < maxNumberOfThreads:
+		counts.append(count)
+		count *= 2
+
+	counts.append(maxNumberOfThreads)
+
+	return counts
+
+
+def runConfiguration(executable, arguments, repetitions):
+	"""Median wall-clock time in microseconds of the `-b` output line over `repetitions` runs."""
+	latencies = []
+	workingDirectory = os.path.dirname(executable)
+
+	for _ in range(repetitions):
+		result = subprocess.run([executable] + arguments, cwd=workingDirectory, capture_output=True, text=True, check=False)
+
+		if result.returncode != 0:
+			raise RuntimeError(f"`{' '.join([executable] + arguments)}` failed with exit code {result.returncode}: {result.stderr.strip()}")
+
+		latencies.append(int(result.stdout.split()[-1]))
+
+	return statistics.median(latencies)
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("executable", help="Path to the native executable (e.g., src/native-exe).")
+	parser.add_argument("--iterations", type=int, default=10000000, help="Monte Carlo iterations per run (-M).")
+	parser.add_argument("--years", type=int, default=40, help="Number of years to retirement (-n).")
+	parser.add_argument("--repetitions", type=int, default=5, help="Runs per configuration.")
+	parser.add_argument("--max-threads", type=int, default=os.cpu_count(), help="Largest number of threads (-p).")
+	parser.add_argument("--policies", default="compact,scatter", help="Comma-separated affinity policies (-A).")
+	arguments = parser.parse_args()
+
+	executable = os.path.abspath(arguments.executable)
+	threadCounts = getThreadCounts(arguments.max_threads)
+
+	print(f"NUMA nodes: {getNumberOfNumaNodes()}, online CPUs: {os.cpu_count()}, iterations: {arguments.iterations}, years: {arguments.years}")
+	print(f"{'policy':<10} {'huge pages':<11} {'threads':>7} {'time (us)':>12} {'iterations/s':>14} {'speedup':>8} {'efficiency':>10}")
+
+	for policy in arguments.policies.split(","):
+		for useHugePages in (False, True):
+			baselineLatency = None
+
+			for numberOfThreads in threadCounts:
+				runArguments = [
+					"-Q", "-A", policy, "-p", str(numberOfThreads),
+					"-n", str(arguments.years), "-S", "0", "-M", str(arguments.iterations), "-b",
+				] + (["-L"] if useHugePages else [])
+				latency = runConfiguration(executable, runArguments, arguments.repetitions)
+				baselineLatency = latency if baselineLatency is None else baselineLatency
+				speedup = baselineLatency / latency
+
+				print(
+					f"{policy:<10} {'yes' if useHugePages else 'no':<11} {numberOfThreads:>7} {latency:>12.0f} "
+					f"{arguments.iterations / latency * 1e6:>14.0f} {speedup:>8.2f} {speedup / numberOfThreads:>10.1%}")
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
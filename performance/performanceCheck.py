@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+"""
+Performance regression gate for the native Monte Carlo path.
+
+Runs a fixed set of scenarios through the benchmarking mode (`-b`) of the native executable,
+repeatedly, and compares the measured latencies against a checked-in baseline with a one-sided
+Mann-Whitney U test. Each run also writes its final progress metrics (`-E`), whose phase durations
+(setup, sampling, postprocessing, output) are compared in the same way, so that a regression is
+attributed to the phase it is in. The gate fails when the latency or a phase of a scenario is slower
+than its baseline with statistical significance and by more than a relative threshold.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+
+
+kRepositoryRoot = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+kDefaultBaselinePath = os.path.join(kRepositoryRoot, "performance", "baseline.json")
+kCSVInputPath = os.path.join(kRepositoryRoot, "inputs", "Finance-IRA-inputs.csv")
+kBaselineVersion = 2
+
+#
+#	The phases of the progress metrics, in the order of a run.
+#
+kPhases = ["setup", "sampling", "postprocessing", "output"]
+
+#
+#	The fixed set of scenarios. `{M}` is replaced by the number of Monte Carlo iterations.
+#
+kScenarios = {
+	"default-n20":	["-n", "20", "-S", "0", "-M", "{M}", "-b"],
+	"default-n60":	["-n", "60", "-S", "0", "-M", "{M}", "-b"],
+	"csv-n20":	["-i", kCSVInputPath, "-n", "20", "-S", "0", "-M", "{M}", "-b"],
+	"csv-n60":	["-i", kCSVInputPath, "-n", "60", "-S", "0", "-M", "{M}", "-b"],
+}
+
+
+def readPhaseDurations(metricsPath):
+	"""Read the duration of each phase, in seconds, from a Prometheus text-format metrics file."""
+	phaseDurations = {}
+
+	with open(metricsPath, encoding="utf-8") as file:
+		for line in file:
+			if line.startswith("ira_phase_duration_seconds{phase=\""):
+				phase = line.split("\"")[1]
+				phaseDurations[phase] = float(line.split()[-1])
+
+	return phaseDurations
+
+
+def runScenario(executable, scenarioArguments, numberOfIterations, workingDirectory, metricsPath):
+	"""
+	Run one scenario once and return its latency in microseconds, from the `-b` output line, and the
+	duration of each phase in seconds, from the final progress metrics.
+	"""
+	command = [executable] + [argument.replace("{M}", str(numberOfIterations)) for argument in scenarioArguments] + ["-E", metricsPath]
+	result = subprocess.run(command, cwd=workingDirectory, capture_output=True, text=True, check=False)
+
+	if result.returncode != 0:
+		raise RuntimeError(f"`{' '.join(command)}` failed with exit code {result.returncode}: {result.stderr.strip()}")
+
+	fields = result.stdout.split()
+
+	if len(fields) < 2:
+		raise RuntimeError(f"`{' '.join(command)}` printed an unexpected benchmark line: {result.stdout.strip()!r}")
+
+	phaseDurations = readPhaseDurations(metricsPath)
+
+	if sorted(phaseDurations) != sorted(kPhases):
+		raise RuntimeError(f"`{' '.join(command)}` wrote unexpected phases to its metrics file: {sorted(phaseDurations)}")
+
+	return int(fields[-1]), phaseDurations
+
+
+def mannWhitneyGreaterPValue(current, baseline):
+	"""
+	One-sided Mann-Whitney U test of H1: `current` tends to be larger than `baseline`.
+
+	Uses the normal approximation with tie correction and continuity correction, which is
+	adequate for the repetition counts used here (>= 8 per sample).
+	"""
+	n1 = len(current)
+	n2 = len(baseline)
+	combined = sorted([(value, 0) for value in current] + [(value, 1) for value in baseline])
+	ranks = [0.0] * len(combined)
+	tieCorrection = 0.0
+	i = 0
+
+	while i < len(combined):
+		j = i
+
+		while (j + 1 < len(combined)) and (combined[j + 1][0] == combined[i][0]):
+			j += 1
+
+		averageRank = (i + j) / 2.0 + 1.0
+		for k in range(i, j + 1):
+			ranks[k] = averageRank
+
+		tieSize = j - i + 1
+		tieCorrection += tieSize ** 3 - tieSize
+		i = j + 1
+
+	rankSumCurrent = sum(rank for rank, (_, group) in zip(ranks, combined) if group == 0)
+	u = rankSumCurrent - n1 * (n1 + 1) / 2.0
+	n = n1 + n2
+	variance = n1 * n2 / 12.0 * ((n + 1) - tieCorrection / (n * (n - 1)))
+
+	if variance <= 0.0:
+		return 0.5
+
+	z = (u - n1 * n2 / 2.0 - 0.5) / math.sqrt(variance)
+
+	return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def measure(executable, numberOfIterations, repetitions, workingDirectory):
+	"""Measure all scenarios, interleaving repetitions so that drifts in machine load affect all alike."""
+	measurements = {name: {"latencyMicroseconds": [], "phaseDurationSeconds": {phase: [] for phase in kPhases}} for name in kScenarios}
+
+	with tempfile.TemporaryDirectory() as metricsDirectory:
+		metricsPath = os.path.join(metricsDirectory, "ira.prom")
+
+		for _ in range(repetitions):
+			for name, scenarioArguments in kScenarios.items():
+				latency, phaseDurations = runScenario(executable, scenarioArguments, numberOfIterations, workingDirectory, metricsPath)
+				measurements[name]["latencyMicroseconds"].append(latency)
+
+				for phase in kPhases:
+					measurements[name]["phaseDurationSeconds"][phase].append(phaseDurations[phase])
+
+	return measurements
+
+
+def compare(current, baseline, arguments, minimumChange):
+	"""
+	Compare current measurements with their baseline, and return the medians, the relative change of
+	the median, the p-value, and whether they regressed. Changes of the median below `minimumChange`
+	are never regressions, so that phases that take microseconds do not fail the gate on noise.
+	"""
+	baselineMedian = statistics.median(baseline)
+	currentMedian = statistics.median(current)
+	change = (currentMedian / baselineMedian - 1.0) if baselineMedian > 0.0 else 0.0
+	pValue = mannWhitneyGreaterPValue(current, baseline)
+	isRegression = (pValue < arguments.alpha) and (change > arguments.threshold) and (currentMedian - baselineMedian > minimumChange)
+
+	return baselineMedian, currentMedian, change, pValue, isRegression
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("executable", help="Path to the native executable (e.g., src/native-exe).")
+	parser.add_argument("--baseline", default=kDefaultBaselinePath, help="Path to the baseline JSON file.")
+	parser.add_argument("--iterations", type=int, default=1000000, help="Monte Carlo iterations per run (-M).")
+	parser.add_argument("--repetitions", type=int, default=15, help="Runs per scenario.")
+	parser.add_argument("--threshold", type=float, default=0.05, help="Relative slowdown of the median latency that fails the gate.")
+	parser.add_argument("--alpha", type=float, default=0.01, help="Significance level of the Mann-Whitney U test.")
+	parser.add_argument("--phase-minimum-change", type=float, default=0.01, help="Slowdown of the median duration of a phase, in seconds, below which it never fails the gate.")
+	parser.add_argument("--allow-other-machine", action="store_true", help="Only warn, instead of failing, if the baseline was recorded on another machine.")
+	parser.add_argument("--update-baseline", action="store_true", help="Record the measurements as the new baseline instead of checking.")
+	arguments = parser.parse_args()
+
+	executable = os.path.abspath(arguments.executable)
+	workingDirectory = os.path.dirname(executable)
+	machine = platform.platform()
+	processor = platform.processor() or platform.machine()
+
+	if not arguments.update_baseline:
+		with open(arguments.baseline, encoding="utf-8") as file:
+			baseline = json.load(file)
+
+		if baseline.get("version") != kBaselineVersion:
+			print(f"Error: The baseline has version {baseline.get('version')}, not {kBaselineVersion}. Record it again with --update-baseline.", file=sys.stderr)
+
+			return 2
+
+		if baseline.get("iterations") != arguments.iterations:
+			print(f"Error: The baseline was recorded with {baseline.get('iterations')} iterations, not {arguments.iterations}.", file=sys.stderr)
+
+			return 2
+
+		if (baseline.get("machine") != machine) or (baseline.get("processor") != processor):
+			message = (
+				f"The baseline was recorded on \"{baseline.get('machine')}\" ({baseline.get('processor')}), "
+				f"not on this machine, \"{machine}\" ({processor}), so its latencies are not comparable.")
+
+			if not arguments.allow_other_machine:
+				print(f"Error: {message} Record a baseline here with --update-baseline, or pass --allow-other-machine.", file=sys.stderr)
+
+				return 2
+
+			print(f"Warning: {message}", file=sys.stderr)
+
+	measurements = measure(executable, arguments.iterations, arguments.repetitions, workingDirectory)
+
+	if arguments.update_baseline:
+		baseline = {
+			"version": kBaselineVersion,
+			"machine": machine,
+			"processor": processor,
+			"iterations": arguments.iterations,
+			"scenarios": measurements,
+		}
+
+		with open(arguments.baseline, "w", encoding="utf-8") as file:
+			json.dump(baseline, file, indent="\t")
+			file.write("\n")
+
+		print(f"Recorded baseline for {len(measurements)} scenarios in {arguments.baseline}.")
+
+		return 0
+
+	failed = False
+	print(f"{'scenario':<14} {'metric':<22} {'baseline':>14} {'current':>14} {'change':>9} {'p-value':>9}  verdict")
+
+	for name, values in measurements.items():
+		baselineValues = baseline.get("scenarios", {}).get(name, {})
+
+		if (len(baselineValues.get("latencyMicroseconds", [])) == 0) or any(len(baselineValues.get("phaseDurationSeconds", {}).get(phase, [])) == 0 for phase in kPhases):
+			print(f"Error: No baseline for scenario \"{name}\". Record one with --update-baseline.", file=sys.stderr)
+
+			return 2
+
+		baselineLatency, currentLatency, change, pValue, isRegression = compare(values["latencyMicroseconds"], baselineValues["latencyMicroseconds"], arguments, 0.0)
+		failed = failed or isRegression
+
+		print(f"{name:<14} {'latency (us)':<22} {baselineLatency:>14.0f} {currentLatency:>14.0f} {change:>+9.1%} {pValue:>9.4f}  {'REGRESSION' if isRegression else 'ok'}")
+		print(f"{'':<14} {'throughput (it/s)':<22} {arguments.iterations / baselineLatency * 1e6:>14.0f} {arguments.iterations / currentLatency * 1e6:>14.0f} {1.0 / (1.0 + change) - 1.0:>+9.1%}")
+
+		for phase in kPhases:
+			baselineDuration, currentDuration, change, pValue, isRegression = compare(
+				values["phaseDurationSeconds"][phase],
+				baselineValues["phaseDurationSeconds"][phase],
+				arguments,
+				arguments.phase_minimum_change)
+			failed = failed or isRegression
+
+			print(f"{'':<14} {phase + ' (s)':<22} {baselineDuration:>14.6f} {currentDuration:>14.6f} {change:>+9.1%} {pValue:>9.4f}  {'REGRESSION' if isRegression else 'ok'}")
+
+	return 1 if failed else 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
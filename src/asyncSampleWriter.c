@@ -0,0 +1,222 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "asyncSampleWriter.h"
+
+
+enum
+{
+	/*
+	 *	Width of the time on the first line of the file: the digits of the largest `uint64_t`.
+	 */
+	kAsyncSampleWriterTimeWidth		= 20,
+	kAsyncSampleWriterMaxCharsPerSample	= 352,
+	kAsyncSampleWriterSamplesPerWrite	= 1024,
+};
+
+/**
+ *	@brief	Format the samples of a chunk as text, one per line, and write them in batches.
+ */
+static bool
+writeChunk(
+	FILE *		file,
+	const double *	samples,
+	size_t		numberOfSamples,
+	char *		text)
+{
+	for (size_t first = 0; first < numberOfSamples; first += kAsyncSampleWriterSamplesPerWrite)
+	{
+		size_t	end = (first + kAsyncSampleWriterSamplesPerWrite < numberOfSamples) ? (first + kAsyncSampleWriterSamplesPerWrite) : numberOfSamples;
+		size_t	length = 0;
+
+		for (size_t i = first; i < end; i++)
+		{
+			length += (size_t) snprintf(&text[length], kAsyncSampleWriterMaxCharsPerSample, "%lf\n", samples[i]);
+		}
+
+		if (fwrite(text, 1, length, file) != length)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void *
+runAsyncSampleWriter(void *  argument)
+{
+	AsyncSampleWriter *	asyncSampleWriter = (AsyncSampleWriter *) argument;
+	char *			text = (char *) checkedMalloc(kAsyncSampleWriterSamplesPerWrite * kAsyncSampleWriterMaxCharsPerSample, __FILE__, __LINE__);
+
+	pthread_mutex_lock(&asyncSampleWriter->mutex);
+
+	while (true)
+	{
+		size_t	chunk;
+		size_t	numberOfSamples;
+		bool	isWritten;
+
+		while (!asyncSampleWriter->isChunkPending && !asyncSampleWriter->isDone)
+		{
+			pthread_cond_wait(&asyncSampleWriter->chunkSubmitted, &asyncSampleWriter->mutex);
+		}
+
+		if (!asyncSampleWriter->isChunkPending)
+		{
+			break;
+		}
+
+		chunk = asyncSampleWriter->pendingChunk;
+		numberOfSamples = asyncSampleWriter->pendingNumberOfSamples;
+
+		/*
+		 *	The chunk stays pending, and thus away from the simulation, until it is written.
+		 */
+		pthread_mutex_unlock(&asyncSampleWriter->mutex);
+		isWritten = writeChunk(asyncSampleWriter->file, asyncSampleWriter->chunks[chunk], numberOfSamples, text);
+		pthread_mutex_lock(&asyncSampleWriter->mutex);
+
+		asyncSampleWriter->hasError = asyncSampleWriter->hasError || !isWritten;
+		asyncSampleWriter->isChunkPending = false;
+		pthread_cond_signal(&asyncSampleWriter->chunkWritten);
+	}
+
+	pthread_mutex_unlock(&asyncSampleWriter->mutex);
+	free(text);
+
+	return NULL;
+}
+
+CommonConstantReturnType
+openAsyncSampleWriter(
+	AsyncSampleWriter *	asyncSampleWriter,
+	const char *		path,
+	size_t			chunkSize)
+{
+	memset(asyncSampleWriter, 0, sizeof(AsyncSampleWriter));
+	asyncSampleWriter->file = fopen(path, "w");
+
+	if (asyncSampleWriter->file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open \"%s\" for writing.\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Placeholder for the time, rewritten in place by `closeAsyncSampleWriter()`.
+	 */
+	fprintf(asyncSampleWriter->file, "%0*d\n", kAsyncSampleWriterTimeWidth, 0);
+
+	asyncSampleWriter->chunkSize = chunkSize;
+	asyncSampleWriter->chunks[0] = (double *) checkedMalloc(chunkSize * sizeof(double), __FILE__, __LINE__);
+	asyncSampleWriter->chunks[1] = (double *) checkedMalloc(chunkSize * sizeof(double), __FILE__, __LINE__);
+	pthread_mutex_init(&asyncSampleWriter->mutex, NULL);
+	pthread_cond_init(&asyncSampleWriter->chunkSubmitted, NULL);
+	pthread_cond_init(&asyncSampleWriter->chunkWritten, NULL);
+
+	if (pthread_create(&asyncSampleWriter->writer, NULL, runAsyncSampleWriter, asyncSampleWriter) != 0)
+	{
+		fprintf(stderr, "Error: Could not create the sample writer thread.\n");
+		fclose(asyncSampleWriter->file);
+		free(asyncSampleWriter->chunks[0]);
+		free(asyncSampleWriter->chunks[1]);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+double *
+getAsyncSampleWriterChunk(AsyncSampleWriter *  asyncSampleWriter)
+{
+	return asyncSampleWriter->chunks[asyncSampleWriter->fillingChunk];
+}
+
+double *
+submitAsyncSampleWriterChunk(
+	AsyncSampleWriter *	asyncSampleWriter,
+	size_t			numberOfSamples)
+{
+	pthread_mutex_lock(&asyncSampleWriter->mutex);
+
+	while (asyncSampleWriter->isChunkPending)
+	{
+		pthread_cond_wait(&asyncSampleWriter->chunkWritten, &asyncSampleWriter->mutex);
+	}
+
+	asyncSampleWriter->pendingChunk = asyncSampleWriter->fillingChunk;
+	asyncSampleWriter->pendingNumberOfSamples = numberOfSamples;
+	asyncSampleWriter->isChunkPending = true;
+	pthread_cond_signal(&asyncSampleWriter->chunkSubmitted);
+	pthread_mutex_unlock(&asyncSampleWriter->mutex);
+
+	asyncSampleWriter->fillingChunk ^= 1;
+
+	return asyncSampleWriter->chunks[asyncSampleWriter->fillingChunk];
+}
+
+void
+flushAsyncSampleWriter(AsyncSampleWriter *  asyncSampleWriter)
+{
+	pthread_mutex_lock(&asyncSampleWriter->mutex);
+	asyncSampleWriter->isDone = true;
+	pthread_cond_signal(&asyncSampleWriter->chunkSubmitted);
+	pthread_mutex_unlock(&asyncSampleWriter->mutex);
+
+	pthread_join(asyncSampleWriter->writer, NULL);
+
+	return;
+}
+
+CommonConstantReturnType
+closeAsyncSampleWriter(
+	AsyncSampleWriter *	asyncSampleWriter,
+	uint64_t		timeInMicroseconds)
+{
+	bool	hasError = asyncSampleWriter->hasError;
+
+	hasError = hasError || (fseek(asyncSampleWriter->file, 0, SEEK_SET) != 0);
+	hasError = hasError || (fprintf(asyncSampleWriter->file, "%0*" PRIu64, kAsyncSampleWriterTimeWidth, timeInMicroseconds) != kAsyncSampleWriterTimeWidth);
+	hasError = (fclose(asyncSampleWriter->file) != 0) || hasError;
+
+	pthread_cond_destroy(&asyncSampleWriter->chunkWritten);
+	pthread_cond_destroy(&asyncSampleWriter->chunkSubmitted);
+	pthread_mutex_destroy(&asyncSampleWriter->mutex);
+	free(asyncSampleWriter->chunks[0]);
+	free(asyncSampleWriter->chunks[1]);
+
+	if (hasError)
+	{
+		fprintf(stderr, "Error: Could not write all samples to the output file.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,107 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "utilities.h"
+
+
+/**
+ *	Writer of Monte Carlo output samples to `data.out` in the background, with two chunk buffers:
+ *	while a writer thread formats and writes one chunk, the simulation fills the other. The first
+ *	line of `data.out`, the time, is only known at the end, so it is written as a fixed-width
+ *	placeholder and rewritten when the writer is closed.
+ */
+typedef struct
+{
+	FILE *			file;
+	double *		chunks[2];
+	size_t			chunkSize;
+	size_t			fillingChunk;
+
+	pthread_mutex_t		mutex;
+	pthread_cond_t		chunkSubmitted;
+	pthread_cond_t		chunkWritten;
+	bool			isChunkPending;
+	size_t			pendingChunk;
+	size_t			pendingNumberOfSamples;
+	bool			isDone;
+	bool			hasError;
+	pthread_t		writer;
+} AsyncSampleWriter;
+
+/**
+ *	@brief	Open the output file and start the writer thread.
+ *
+ *	@param	asyncSampleWriter	: Pointer to the writer to open.
+ *	@param	path			: Path of the output file.
+ *	@param	chunkSize		: Number of samples per chunk.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	openAsyncSampleWriter(
+					AsyncSampleWriter *	asyncSampleWriter,
+					const char *		path,
+					size_t			chunkSize);
+
+/**
+ *	@brief	Get the chunk to fill with samples.
+ *
+ *	@param	asyncSampleWriter	: Pointer to the writer.
+ *	@return				: The chunk, with room for `chunkSize` samples.
+ */
+double *	getAsyncSampleWriterChunk(AsyncSampleWriter *  asyncSampleWriter);
+
+/**
+ *	@brief	Hand the filled chunk to the writer thread, and get the other chunk to fill next.
+ *
+ *	Blocks only while the writer thread is still writing the other chunk.
+ *
+ *	@param	asyncSampleWriter	: Pointer to the writer.
+ *	@param	numberOfSamples		: Number of samples in the filled chunk.
+ *	@return				: The next chunk to fill.
+ */
+double *	submitAsyncSampleWriterChunk(
+			AsyncSampleWriter *	asyncSampleWriter,
+			size_t			numberOfSamples);
+
+/**
+ *	@brief	Wait until all submitted chunks are written, and stop the writer thread.
+ *
+ *	@param	asyncSampleWriter	: Pointer to the writer.
+ */
+void	flushAsyncSampleWriter(AsyncSampleWriter *  asyncSampleWriter);
+
+/**
+ *	@brief	Write the time to the first line of the file, close it, and release the chunks.
+ *
+ *	@param	asyncSampleWriter	: Pointer to a flushed writer.
+ *	@param	timeInMicroseconds	: The time for the first line of the file.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if all samples were written, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	closeAsyncSampleWriter(
+					AsyncSampleWriter *	asyncSampleWriter,
+					uint64_t		timeInMicroseconds);
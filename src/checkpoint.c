@@ -0,0 +1,341 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "parallelMonteCarlo.h"
+#include "timeBudget.h"
+
+
+#define kCheckpointFingerprintOffsetBasis	(UINT64_C(0xcbf29ce484222325))
+#define kCheckpointFingerprintPrime		(UINT64_C(0x100000001b3))
+
+static const char	kCheckpointMagic[8] = "IRACKPT";
+
+enum
+{
+	kCheckpointVersion = 2,
+};
+
+/**
+ *	Header of a checkpoint file, which is followed by `numberOfSamples` samples. All fields are in
+ *	the byte order of the machine, as checkpoints are resumed on the same kind of machine.
+ */
+typedef struct
+{
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	blockSize;
+	uint64_t	fingerprint;
+	uint64_t	seed;
+	uint64_t	nextStreamIndex;
+	uint64_t	numberOfIterations;
+	uint64_t	numberOfSamples;
+	double		mean;
+	double		variance;
+} CheckpointHeader;
+
+/**
+ *	@brief	Add bytes to an FNV-1a hash.
+ */
+static uint64_t
+hashBytes(uint64_t  hash, const void *  data, size_t  size)
+{
+	const unsigned char *	bytes = (const unsigned char *) data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * kCheckpointFingerprintPrime;
+	}
+
+	return hash;
+}
+
+uint64_t
+calculateCheckpointFingerprint(CommandLineArguments *  arguments)
+{
+	uint64_t	hash = kCheckpointFingerprintOffsetBasis;
+	uint64_t	numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	uint64_t	blockLength = arguments->inputBootstrap.blockLength;
+	int		outputSelect = arguments->common.outputSelect;
+
+	hash = hashBytes(hash, &arguments->numberOfYearsToRetirement, sizeof(arguments->numberOfYearsToRetirement));
+	hash = hashBytes(hash, &arguments->periodsPerYear, sizeof(arguments->periodsPerYear));
+	hash = hashBytes(hash, &outputSelect, sizeof(outputSelect));
+	hash = hashBytes(hash, &numberOfIterations, sizeof(numberOfIterations));
+	hash = hashBytes(hash, &arguments->seed, sizeof(arguments->seed));
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		hash = hashBytes(hash, &arguments->isInputVariableSet[j], sizeof(arguments->isInputVariableSet[j]));
+
+		if (arguments->isInputVariableSet[j])
+		{
+			hash = hashBytes(hash, arguments->inputVariablesUxStrings[j], strlen(arguments->inputVariablesUxStrings[j]));
+		}
+	}
+
+	hash = hashBytes(hash, &arguments->inputCorrelation.isEnabled, sizeof(arguments->inputCorrelation.isEnabled));
+	hash = hashBytes(hash, arguments->inputCorrelation.autocorrelation, sizeof(arguments->inputCorrelation.autocorrelation));
+	hash = hashBytes(hash, arguments->inputCorrelation.crossCorrelation, sizeof(arguments->inputCorrelation.crossCorrelation));
+	hash = hashBytes(hash, &arguments->inputBootstrap.isEnabled, sizeof(arguments->inputBootstrap.isEnabled));
+	hash = hashBytes(hash, &blockLength, sizeof(blockLength));
+	hash = hashBytes(hash, &arguments->common.isInputFromFileEnabled, sizeof(arguments->common.isInputFromFileEnabled));
+
+	if (arguments->common.isInputFromFileEnabled)
+	{
+		hash = hashBytes(hash, arguments->common.inputFilePath, strlen(arguments->common.inputFilePath));
+	}
+
+	return hash;
+}
+
+/**
+ *	@brief	Write a checkpoint of the first `numberOfSamples` samples, replacing the checkpoint file
+ *		atomically.
+ */
+static void
+writeCheckpointFile(CheckpointWriter *  checkpointWriter, size_t  numberOfSamples)
+{
+	CommandLineArguments *	arguments = checkpointWriter->arguments;
+	char			temporaryPath[kCommonConstantMaxCharsPerFilepath + 8];
+	CheckpointHeader	header;
+	double			mean = 0.0;
+	double			sumOfSquaredDeviations = 0.0;
+	FILE *			file;
+	bool			isWritten;
+
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		double	delta = checkpointWriter->samples[i] - mean;
+
+		mean += delta / (double)(i + 1);
+		sumOfSquaredDeviations += delta * (checkpointWriter->samples[i] - mean);
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kCheckpointMagic, sizeof(header.magic));
+	header.version = kCheckpointVersion;
+	header.blockSize = kParallelMonteCarloBlockSize;
+	header.fingerprint = checkpointWriter->fingerprint;
+	header.seed = arguments->seed;
+	header.nextStreamIndex = numberOfSamples / kParallelMonteCarloBlockSize;
+	header.numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	header.numberOfSamples = numberOfSamples;
+	header.mean = mean;
+	header.variance = (numberOfSamples > 1) ? sumOfSquaredDeviations / (double)(numberOfSamples - 1) : 0.0;
+
+	snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", arguments->checkpointFilePath);
+	file = fopen(temporaryPath, "wb");
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Warning: Could not open checkpoint file \"%s\".\n", temporaryPath);
+
+		return;
+	}
+
+	/*
+	 *	The data must be on disk before the rename makes it the checkpoint.
+	 */
+	isWritten = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+			(fwrite(checkpointWriter->samples, sizeof(double), numberOfSamples, file) == numberOfSamples) &&
+			(fflush(file) == 0) &&
+			(fsync(fileno(file)) == 0);
+	isWritten = (fclose(file) == 0) && isWritten;
+
+	if (!isWritten || (rename(temporaryPath, arguments->checkpointFilePath) != 0))
+	{
+		fprintf(stderr, "Warning: Could not write checkpoint file \"%s\".\n", arguments->checkpointFilePath);
+	}
+
+	return;
+}
+
+static void *
+runCheckpointWriter(void *  argument)
+{
+	CheckpointWriter *	checkpointWriter = (CheckpointWriter *) argument;
+
+	pthread_mutex_lock(&checkpointWriter->mutex);
+
+	while (true)
+	{
+		while (!checkpointWriter->isCheckpointPending && !checkpointWriter->isDone)
+		{
+			pthread_cond_wait(&checkpointWriter->checkpointRequested, &checkpointWriter->mutex);
+		}
+
+		if (!checkpointWriter->isCheckpointPending)
+		{
+			break;
+		}
+
+		pthread_mutex_unlock(&checkpointWriter->mutex);
+		writeCheckpointFile(checkpointWriter, checkpointWriter->pendingNumberOfSamples);
+		pthread_mutex_lock(&checkpointWriter->mutex);
+
+		checkpointWriter->isCheckpointPending = false;
+	}
+
+	pthread_mutex_unlock(&checkpointWriter->mutex);
+
+	return NULL;
+}
+
+CommonConstantReturnType
+readCheckpoint(
+	CommandLineArguments *	arguments,
+	double *		samples,
+	size_t *		numberOfSamples)
+{
+	CheckpointHeader	header;
+	FILE *			file = fopen(arguments->checkpointFilePath, "rb");
+
+	*numberOfSamples = 0;
+
+	if ((file == NULL) && (errno == ENOENT))
+	{
+		fprintf(stderr, "Note: No checkpoint file \"%s\" to resume from, starting from the first iteration.\n", arguments->checkpointFilePath);
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open checkpoint file \"%s\".\n", arguments->checkpointFilePath);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fread(&header, sizeof(header), 1, file) != 1) ||
+		(memcmp(header.magic, kCheckpointMagic, sizeof(header.magic)) != 0) ||
+		(header.version != kCheckpointVersion) ||
+		(header.blockSize != kParallelMonteCarloBlockSize))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a checkpoint file of this version of the application.\n", arguments->checkpointFilePath);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((header.fingerprint != calculateCheckpointFingerprint(arguments)) ||
+		(header.numberOfSamples > arguments->common.numberOfMonteCarloIterations) ||
+		((header.numberOfSamples % kParallelMonteCarloBlockSize) != 0) ||
+		(header.nextStreamIndex != header.numberOfSamples / kParallelMonteCarloBlockSize))
+	{
+		fprintf(stderr, "Error: Checkpoint file \"%s\" is from a run with other arguments.\n", arguments->checkpointFilePath);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (fread(samples, sizeof(double), header.numberOfSamples, file) != header.numberOfSamples)
+	{
+		fprintf(stderr, "Error: Checkpoint file \"%s\" is truncated.\n", arguments->checkpointFilePath);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	fclose(file);
+
+	*numberOfSamples = header.numberOfSamples;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+startCheckpointWriter(
+	CheckpointWriter *	checkpointWriter,
+	CommandLineArguments *	arguments,
+	const double *		samples)
+{
+	memset(checkpointWriter, 0, sizeof(CheckpointWriter));
+	checkpointWriter->arguments = arguments;
+	checkpointWriter->samples = samples;
+	checkpointWriter->fingerprint = calculateCheckpointFingerprint(arguments);
+	checkpointWriter->lastCheckpointTime = getMonotonicTimeInSeconds();
+	pthread_mutex_init(&checkpointWriter->mutex, NULL);
+	pthread_cond_init(&checkpointWriter->checkpointRequested, NULL);
+
+	if (pthread_create(&checkpointWriter->writer, NULL, runCheckpointWriter, checkpointWriter) != 0)
+	{
+		fprintf(stderr, "Error: Could not create the checkpoint writer thread.\n");
+		pthread_cond_destroy(&checkpointWriter->checkpointRequested);
+		pthread_mutex_destroy(&checkpointWriter->mutex);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+requestCheckpoint(
+	CheckpointWriter *	checkpointWriter,
+	size_t			numberOfSamples)
+{
+	double	now = getMonotonicTimeInSeconds();
+
+	if ((now - checkpointWriter->lastCheckpointTime) < checkpointWriter->arguments->checkpointIntervalInSeconds)
+	{
+		return;
+	}
+
+	if (pthread_mutex_trylock(&checkpointWriter->mutex) != 0)
+	{
+		return;
+	}
+
+	if (!checkpointWriter->isCheckpointPending)
+	{
+		checkpointWriter->pendingNumberOfSamples = numberOfSamples;
+		checkpointWriter->isCheckpointPending = true;
+		checkpointWriter->lastCheckpointTime = now;
+		pthread_cond_signal(&checkpointWriter->checkpointRequested);
+	}
+
+	pthread_mutex_unlock(&checkpointWriter->mutex);
+
+	return;
+}
+
+void
+stopCheckpointWriter(CheckpointWriter *  checkpointWriter)
+{
+	pthread_mutex_lock(&checkpointWriter->mutex);
+	checkpointWriter->isDone = true;
+	pthread_cond_signal(&checkpointWriter->checkpointRequested);
+	pthread_mutex_unlock(&checkpointWriter->mutex);
+
+	pthread_join(checkpointWriter->writer, NULL);
+	pthread_cond_destroy(&checkpointWriter->checkpointRequested);
+	pthread_mutex_destroy(&checkpointWriter->mutex);
+
+	return;
+}
@@ -0,0 +1,110 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "utilities.h"
+
+
+/**
+ *	Writer of checkpoints of a Monte Carlo run, in the background.
+ *
+ *	A checkpoint holds the number of samples completed, which is a multiple of the block size of the
+ *	sampling streams, the state of the sampling streams (the seed and the index of the next
+ *	stream), the running mean and variance, and the samples completed. The samples completed are
+ *	not written to again by the simulation, so the writer thread reads them in place, and the
+ *	simulation never waits for a checkpoint.
+ */
+typedef struct
+{
+	CommandLineArguments *	arguments;
+	const double *		samples;
+	uint64_t		fingerprint;
+	double			lastCheckpointTime;
+
+	pthread_mutex_t		mutex;
+	pthread_cond_t		checkpointRequested;
+	bool			isCheckpointPending;
+	size_t			pendingNumberOfSamples;
+	bool			isDone;
+	pthread_t		writer;
+} CheckpointWriter;
+
+/**
+ *	@brief	Calculate the fingerprint of the configuration of a run, which a checkpoint must match
+ *		to be resumed.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@return			: The fingerprint.
+ */
+uint64_t	calculateCheckpointFingerprint(CommandLineArguments *  arguments);
+
+/**
+ *	@brief	Read the checkpoint file of `arguments`, to resume a run.
+ *
+ *	A missing checkpoint file is not an error: the run then starts from the first iteration.
+ *
+ *	@param	arguments		: Pointer to command-line arguments struct.
+ *	@param	samples			: Buffer for `numberOfMonteCarloIterations` samples, populated with the samples completed.
+ *	@param	numberOfSamples		: Pointer to the number of samples completed, populated on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	readCheckpoint(
+					CommandLineArguments *	arguments,
+					double *		samples,
+					size_t *		numberOfSamples);
+
+/**
+ *	@brief	Start the checkpoint writer thread.
+ *
+ *	@param	checkpointWriter	: Pointer to the writer to start.
+ *	@param	arguments		: Pointer to command-line arguments struct.
+ *	@param	samples			: The buffer of samples of the run.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	startCheckpointWriter(
+					CheckpointWriter *	checkpointWriter,
+					CommandLineArguments *	arguments,
+					const double *		samples);
+
+/**
+ *	@brief	Hand a checkpoint to the writer thread if the checkpoint interval has elapsed.
+ *
+ *	Never blocks: if the writer thread is still writing the previous checkpoint, no checkpoint is
+ *	taken.
+ *
+ *	@param	checkpointWriter	: Pointer to the writer.
+ *	@param	numberOfSamples		: Number of samples completed, a multiple of `kParallelMonteCarloBlockSize`.
+ */
+void	requestCheckpoint(
+		CheckpointWriter *	checkpointWriter,
+		size_t			numberOfSamples);
+
+/**
+ *	@brief	Wait for the checkpoint being written, if any, and stop the writer thread.
+ *
+ *	@param	checkpointWriter	: Pointer to the writer.
+ */
+void	stopCheckpointWriter(CheckpointWriter *  checkpointWriter);
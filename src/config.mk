@@ -2,4 +2,30 @@ SOURCES =\
 	main.c\
 	kernel.c\
 	common.c\
-	utilities.c
+	utilities.c\
+	correlation.c\
+	specializedKernels.c\
+	household.c\
+	importanceSampling.c\
+	contributionSolver.c\
+	sampling.c\
+	streamingPipeline.c\
+	statistics.c\
+	timeBudget.c\
+	parallelMonteCarlo.c\
+	progressMetrics.c\
+	asyncSampleWriter.c\
+	inputBootstrap.c\
+	moments.c\
+	checkpoint.c\
+	scenarioComparison.c\
+	controlVariate.c\
+	sampleArchive.c\
+	fusedKernel.c\
+	decumulation.c\
+	sobolIndices.c
+
+LIBIRA_SOURCES =\
+	ira.c\
+	kernel.c\
+	sampling.c
@@ -0,0 +1,165 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "contributionSolver.h"
+#include "kernel.h"
+#include "specializedKernels.h"
+#include "statistics.h"
+
+
+/*
+ *	Two-sided 95% quantile of the standard normal distribution, for the distribution-free
+ *	confidence interval of the quantile.
+ */
+#define kContributionSolverConfidenceIntervalZ	(1.959963984540054)
+
+static size_t
+clampRank(double rank, size_t numberOfSamples)
+{
+	if (rank < 0.0)
+	{
+		return 0;
+	}
+
+	if (rank > (double)(numberOfSamples - 1))
+	{
+		return numberOfSamples - 1;
+	}
+
+	return (size_t) rank;
+}
+
+CommonConstantReturnType
+runContributionSolverMode(CommandLineArguments *  arguments)
+{
+	double *		inputVariables[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	CalculateOutputFunction	calculateOutputFunction;
+	size_t			numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	double *		multipliers;
+	double			confidence = arguments->contributionConfidence;
+	double			rankStandardDeviation;
+	size_t			numberOfSuccessfulPaths;
+	size_t			rank;
+	size_t			lowerRank;
+	size_t			upperRank;
+	double			contribution;
+	clock_t			start;
+	double			cpuTimeUsedInSeconds;
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		inputVariables[i] = (double *) checkedMalloc(arguments->numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	multipliers = (double *) checkedMalloc(numberOfIterations * sizeof(double), __FILE__, __LINE__);
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, arguments->numberOfYearsToRetirement);
+
+	start = clock();
+
+	/*
+	 *	With a unit contribution in every year, the kernel yields the future value per unit of
+	 *	annual contribution of the path, i.e., the sum of the growth multipliers of its years.
+	 */
+	for (size_t i = 0; i < numberOfIterations; i++)
+	{
+		setInputVariables(arguments, inputVariables);
+
+		for (int year = 0; year < arguments->numberOfYearsToRetirement; year++)
+		{
+			inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount][year] = 1.0;
+		}
+
+		calculateOutputFunction(arguments, arguments->numberOfYearsToRetirement, inputVariables, outputDistributions);
+		multipliers[i] = outputDistributions[arguments->common.outputSelect];
+	}
+
+	sortDoubleSamplesInParallel(multipliers, numberOfIterations, arguments->numberOfThreads);
+
+	/*
+	 *	A contribution reaches the target on a path if it is at least the target divided by the
+	 *	path's multiplier. It does so on a fraction `confidence` of the paths when the divisor is the
+	 *	multiplier of rank `numberOfIterations - ceil(confidence * numberOfIterations)`. The ranks of
+	 *	the confidence interval follow from the binomial distribution of the number of paths below
+	 *	the true quantile.
+	 */
+	numberOfSuccessfulPaths = (size_t) ceil(confidence * numberOfIterations);
+	numberOfSuccessfulPaths = (numberOfSuccessfulPaths == 0) ? 1 : numberOfSuccessfulPaths;
+	rank = numberOfIterations - numberOfSuccessfulPaths;
+	rankStandardDeviation = sqrt(numberOfIterations * confidence * (1.0 - confidence));
+	lowerRank = clampRank(floor(rank - kContributionSolverConfidenceIntervalZ * rankStandardDeviation), numberOfIterations);
+	upperRank = clampRank(ceil(rank + kContributionSolverConfidenceIntervalZ * rankStandardDeviation), numberOfIterations);
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	if (!(multipliers[lowerRank] > 0.0))
+	{
+		fprintf(stderr, "Error: The target is not reachable with confidence %lf, as the future value per unit of contribution is not positive.\n", confidence);
+		free(multipliers);
+
+		for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+		{
+			free(inputVariables[i]);
+		}
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	contribution = arguments->shortfallTarget / multipliers[rank];
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %" PRIu64 "\n", contribution, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		printf(
+			"Required annual contribution for P(%s >= %.2lf) >= %lf is $%.2lf (95%% confidence interval [$%.2lf, $%.2lf]).\n",
+			kOutputVariableNames[arguments->common.outputSelect],
+			arguments->shortfallTarget,
+			confidence,
+			contribution,
+			arguments->shortfallTarget / multipliers[upperRank],
+			arguments->shortfallTarget / multipliers[lowerRank]);
+		printf("Kernel evaluations: %zu.\n", numberOfIterations);
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	free(multipliers);
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		free(inputVariables[i]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,443 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "controlVariate.h"
+#include "specializedKernels.h"
+
+
+enum
+{
+	/*
+	 *	The expectations need binomial coefficients of order up to twice the number of years, which
+	 *	overflow doubles beyond order 1029.
+	 */
+	kControlVariateMaxNumberOfYears = 500,
+};
+
+/**
+ *	Running means, sums of squared deviations, and sum of cross deviations of a pair of variables.
+ */
+typedef struct
+{
+	double	meanX;
+	double	meanY;
+	double	sumOfSquaredDeviationsX;
+	double	sumOfSquaredDeviationsY;
+	double	sumOfCrossDeviations;
+} RunningCovariance;
+
+static void
+addToRunningCovariance(RunningCovariance *  runningCovariance, double  x, double  y, size_t  numberOfSamples)
+{
+	double	deltaX = x - runningCovariance->meanX;
+	double	deltaY = y - runningCovariance->meanY;
+
+	runningCovariance->meanX += deltaX / (double) numberOfSamples;
+	runningCovariance->meanY += deltaY / (double) numberOfSamples;
+	runningCovariance->sumOfSquaredDeviationsX += deltaX * (x - runningCovariance->meanX);
+	runningCovariance->sumOfSquaredDeviationsY += deltaY * (y - runningCovariance->meanY);
+	runningCovariance->sumOfCrossDeviations += deltaX * (y - runningCovariance->meanY);
+
+	return;
+}
+
+/**
+ *	@brief	Calculate the raw moments `E[(offset + scale * v)^k]`, for `k` in `[0, order]`, of an input
+ *		`v` that is constant (set from the command line) or has its default uniform distribution.
+ */
+static void
+calculateScaledInputRawMoments(
+	CommandLineArguments *	arguments,
+	InputDistributionIndex	input,
+	double			offset,
+	double			scale,
+	size_t			order,
+	double *		rawMoments)
+{
+	double	value = 0.0;
+	double	low;
+	double	high;
+	double	lowPower;
+	double	highPower;
+
+	if (arguments->isInputVariableSet[input])
+	{
+		sscanf(arguments->inputVariablesUxStrings[input], "%lf", &value);
+		value = offset + scale * value;
+		rawMoments[0] = 1.0;
+
+		for (size_t k = 1; k <= order; k++)
+		{
+			rawMoments[k] = rawMoments[k - 1] * value;
+		}
+
+		return;
+	}
+
+	/*
+	 *	An affine map of a uniform variable is uniform: E[x^k] = (high^(k+1) - low^(k+1)) / ((k+1) (high - low)).
+	 */
+	low = offset + scale * kDefaultInputDistributionMin[input];
+	high = offset + scale * kDefaultInputDistributionMax[input];
+	lowPower = low;
+	highPower = high;
+
+	for (size_t k = 0; k <= order; k++)
+	{
+		rawMoments[k] = (highPower - lowPower) / ((double)(k + 1) * (high - low));
+		lowPower *= low;
+		highPower *= high;
+	}
+
+	return;
+}
+
+/**
+ *	@brief	Calculate the raw moments of the sum of two independent variables from theirs:
+ *		`E[(x + y)^j] = sum_k C(j, k) E[x^k] E[y^(j-k)]`.
+ */
+static void
+convolveRawMoments(
+	const double *	rawMomentsX,
+	const double *	rawMomentsY,
+	size_t		order,
+	double *	rawMomentsOfSum)
+{
+	for (size_t j = 0; j <= order; j++)
+	{
+		double	binomialCoefficient = 1.0;
+		double	sum = 0.0;
+
+		for (size_t k = 0; k <= j; k++)
+		{
+			sum += binomialCoefficient * rawMomentsX[k] * rawMomentsY[j - k];
+			binomialCoefficient = binomialCoefficient * (double)(j - k) / (double)(k + 1);
+		}
+
+		rawMomentsOfSum[j] = sum;
+	}
+
+	return;
+}
+
+/**
+ *	@brief	Calculate the raw moments of the average of `n` independent copies of a variable, by
+ *		binary powering of the convolution of the moments of `x / n`.
+ */
+static void
+calculateRawMomentsOfAverage(
+	const double *	rawMoments,
+	size_t		n,
+	size_t		order,
+	double *	rawMomentsOfAverage)
+{
+	double *	power = (double *) checkedMalloc(3 * (order + 1) * sizeof(double), __FILE__, __LINE__);
+	double *	scratch = power + (order + 1);
+	double *	result = scratch + (order + 1);
+
+	for (size_t k = 0; k <= order; k++)
+	{
+		power[k] = rawMoments[k] / pow((double) n, (double) k);
+		result[k] = (k == 0) ? 1.0 : 0.0;
+	}
+
+	for (size_t remaining = n; remaining > 0; remaining >>= 1)
+	{
+		if (remaining & 1)
+		{
+			convolveRawMoments(result, power, order, scratch);
+			memcpy(result, scratch, (order + 1) * sizeof(double));
+		}
+
+		if (remaining > 1)
+		{
+			convolveRawMoments(power, power, order, scratch);
+			memcpy(power, scratch, (order + 1) * sizeof(double));
+		}
+	}
+
+	memcpy(rawMomentsOfAverage, result, (order + 1) * sizeof(double));
+	free(power);
+
+	return;
+}
+
+/**
+ *	@brief	Evaluate the closed-form future value of constant inputs at the year averages of a path.
+ *
+ *	With a contribution `a` and a growth rate `g` in every year, the future value is
+ *	`a * S(g)`, where `S(g) = sum_{k=1}^{n} (1 + g)^k`.
+ */
+static double
+calculateClosedFormFutureValueAtAverages(
+	OutputDistributionIndex	outputSelect,
+	int			numberOfYearsToRetirement,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	double	averageContribution = 0.0;
+	double	averageGrowthRate = 0.0;
+	double	averageWithdrawalRate = 0.0;
+	double	growthPower = 1.0;
+	double	growthSum = 0.0;
+
+	for (int i = 0; i < numberOfYearsToRetirement; i++)
+	{
+		double	interestRate = inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate][i] / 100;
+
+		averageContribution += inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount][i];
+		averageWithdrawalRate += inputVariables[kInputDistributionIndexWithdrawalRate][i];
+		averageGrowthRate += (outputSelect == kOutputDistributionIndexFutureValueTaxed) ?
+					interestRate * (1.0 - (inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest][i] / 100)) :
+					interestRate;
+	}
+
+	averageContribution /= numberOfYearsToRetirement;
+	averageWithdrawalRate /= numberOfYearsToRetirement;
+	averageGrowthRate /= numberOfYearsToRetirement;
+
+	for (int k = 1; k <= numberOfYearsToRetirement; k++)
+	{
+		growthPower *= 1.0 + averageGrowthRate;
+		growthSum += growthPower;
+	}
+
+	if (outputSelect == kOutputDistributionIndexFutureValueTaxed)
+	{
+		return averageContribution * growthSum;
+	}
+
+	return averageContribution * (1.0 - (averageWithdrawalRate / 100)) * growthSum;
+}
+
+/**
+ *	@brief	Calculate the exact expectations of the control variate and of its square.
+ *
+ *	The average contribution, the average withdrawal factor and the average growth rate depend on
+ *	disjoint, independent inputs, so the expectations factor. `S(g)` and `S(g)^2` are polynomials
+ *	in `g`, whose expectations follow from the raw moments of the average growth rate.
+ */
+static void
+calculateControlVariateExpectations(
+	CommandLineArguments *	arguments,
+	double *		expectation,
+	double *		expectationOfSquare)
+{
+	size_t		n = (size_t) arguments->numberOfYearsToRetirement;
+	size_t		order = 2 * n;
+	double *	growthRateRawMoments = (double *) checkedMalloc(4 * (order + 1) * sizeof(double), __FILE__, __LINE__);
+	double *	scratch = growthRateRawMoments + (order + 1);
+	double *	growthSumCoefficients = scratch + (order + 1);
+	double *	squaredGrowthSumCoefficients = growthSumCoefficients + (order + 1);
+	double		contributionRawMoments[3];
+	double		withdrawalFactorRawMoments[3] = {1.0, 1.0, 1.0};
+	double		contributionFactor[2];
+	double		growthSumExpectation = 0.0;
+	double		squaredGrowthSumExpectation = 0.0;
+	double		binomialCoefficient = (double) n * (double)(n + 1) / 2.0;
+
+	/*
+	 *	The growth rate of a year is (c / 100) (1 - r / 100) for the taxed output, and c / 100 for
+	 *	the other.
+	 */
+	calculateScaledInputRawMoments(arguments, kInputDistributionIndexCompoundedAnnualInterestRate, 0.0, 0.01, order, growthRateRawMoments);
+
+	if (arguments->common.outputSelect == kOutputDistributionIndexFutureValueTaxed)
+	{
+		calculateScaledInputRawMoments(arguments, kInputDistributionIndexAssumedTaxRateOnInterest, 1.0, -0.01, order, scratch);
+
+		for (size_t k = 0; k <= order; k++)
+		{
+			growthRateRawMoments[k] *= scratch[k];
+		}
+	}
+	else
+	{
+		calculateScaledInputRawMoments(arguments, kInputDistributionIndexWithdrawalRate, 1.0, -0.01, 2, withdrawalFactorRawMoments);
+	}
+
+	calculateRawMomentsOfAverage(growthRateRawMoments, n, order, scratch);
+	calculateScaledInputRawMoments(arguments, kInputDistributionIndexTotalAnnualContributionToAccount, 0.0, 1.0, 2, contributionRawMoments);
+
+	/*
+	 *	S(g) = n + sum_{l=1}^{n} C(n + 1, l + 1) g^l, by the hockey-stick identity.
+	 */
+	memset(growthSumCoefficients, 0, 2 * (order + 1) * sizeof(double));
+	growthSumCoefficients[0] = (double) n;
+
+	for (size_t l = 1; l <= n; l++)
+	{
+		growthSumCoefficients[l] = binomialCoefficient;
+		binomialCoefficient = binomialCoefficient * (double)(n - l) / (double)(l + 2);
+	}
+
+	for (size_t l = 0; l <= n; l++)
+	{
+		for (size_t m = 0; m <= n; m++)
+		{
+			squaredGrowthSumCoefficients[l + m] += growthSumCoefficients[l] * growthSumCoefficients[m];
+		}
+	}
+
+	for (size_t l = 0; l <= order; l++)
+	{
+		growthSumExpectation += growthSumCoefficients[l] * scratch[l];
+		squaredGrowthSumExpectation += squaredGrowthSumCoefficients[l] * scratch[l];
+	}
+
+	/*
+	 *	The average of n independent copies of x has mean E[x] and second moment E[x]^2 + Var(x) / n.
+	 */
+	contributionFactor[0] = contributionRawMoments[1] * withdrawalFactorRawMoments[1];
+	contributionFactor[1] = (contributionRawMoments[1] * contributionRawMoments[1] + (contributionRawMoments[2] - contributionRawMoments[1] * contributionRawMoments[1]) / (double) n) *
+				(withdrawalFactorRawMoments[1] * withdrawalFactorRawMoments[1] + (withdrawalFactorRawMoments[2] - withdrawalFactorRawMoments[1] * withdrawalFactorRawMoments[1]) / (double) n);
+
+	*expectation = contributionFactor[0] * growthSumExpectation;
+	*expectationOfSquare = contributionFactor[1] * squaredGrowthSumExpectation;
+
+	free(growthRateRawMoments);
+
+	return;
+}
+
+CommonConstantReturnType
+runControlVariateMode(CommandLineArguments *  arguments)
+{
+	size_t			numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	int			numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+	OutputDistributionIndex	outputSelect = arguments->common.outputSelect;
+	double *		inputVariables[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	CalculateOutputFunction	calculateOutputFunction;
+	RunningCovariance	firstMoments = {0};
+	RunningCovariance	secondMoments = {0};
+	double			controlExpectation;
+	double			controlExpectationOfSquare;
+	double			degreesOfFreedom;
+	double			varianceOfOutput;
+	double			coefficient;
+	double			correlation;
+	double			controlVariateMean;
+	double			controlVariateSecondMoment;
+	double			controlVariateVariance;
+	double			controlVariateStandardError;
+	double			plainStandardError;
+	double			cpuTimeUsedInSeconds;
+	clock_t			start;
+
+	if (numberOfYearsToRetirement > kControlVariateMaxNumberOfYears)
+	{
+		fprintf(stderr, "Error: Control-variate mode supports at most %d years to retirement.\n", kControlVariateMaxNumberOfYears);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		inputVariables[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, numberOfYearsToRetirement);
+
+	start = clock();
+
+	calculateControlVariateExpectations(arguments, &controlExpectation, &controlExpectationOfSquare);
+
+	for (size_t i = 0; i < numberOfIterations; i++)
+	{
+		double	output;
+		double	control;
+
+		setInputVariables(arguments, inputVariables);
+		calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+
+		output = outputDistributions[outputSelect];
+		control = calculateClosedFormFutureValueAtAverages(outputSelect, numberOfYearsToRetirement, inputVariables);
+
+		addToRunningCovariance(&firstMoments, output, control, i + 1);
+		addToRunningCovariance(&secondMoments, output * output, control * control, i + 1);
+	}
+
+	/*
+	 *	The optimal coefficient of a control is Cov(F, C) / Var(C), and it leaves a fraction
+	 *	1 - rho^2 of the variance of the estimator of the mean. The second moment of the output,
+	 *	for its variance, is corrected the same way with the square of the control.
+	 */
+	degreesOfFreedom = (numberOfIterations > 1) ? (double)(numberOfIterations - 1) : 1.0;
+	varianceOfOutput = firstMoments.sumOfSquaredDeviationsX / degreesOfFreedom;
+	coefficient = (firstMoments.sumOfSquaredDeviationsY > 0.0) ? firstMoments.sumOfCrossDeviations / firstMoments.sumOfSquaredDeviationsY : 0.0;
+	correlation = ((firstMoments.sumOfSquaredDeviationsX > 0.0) && (firstMoments.sumOfSquaredDeviationsY > 0.0)) ?
+			firstMoments.sumOfCrossDeviations / sqrt(firstMoments.sumOfSquaredDeviationsX * firstMoments.sumOfSquaredDeviationsY) :
+			0.0;
+	controlVariateMean = firstMoments.meanX - coefficient * (firstMoments.meanY - controlExpectation);
+	controlVariateStandardError = sqrt(varianceOfOutput * (1.0 - correlation * correlation) / (double) numberOfIterations);
+	plainStandardError = sqrt(varianceOfOutput / (double) numberOfIterations);
+
+	coefficient = (secondMoments.sumOfSquaredDeviationsY > 0.0) ? secondMoments.sumOfCrossDeviations / secondMoments.sumOfSquaredDeviationsY : 0.0;
+	controlVariateSecondMoment = secondMoments.meanX - coefficient * (secondMoments.meanY - controlExpectationOfSquare);
+	controlVariateVariance = (controlVariateSecondMoment - controlVariateMean * controlVariateMean) * (double) numberOfIterations / degreesOfFreedom;
+	controlVariateVariance = (controlVariateVariance > 0.0) ? controlVariateVariance : 0.0;
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %lf %" PRIu64 "\n", controlVariateMean, controlVariateStandardError, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		printf(
+			"%s, plain Monte Carlo: mean $%.2lf (standard error $%.2lf), standard deviation $%.2lf.\n",
+			kOutputVariableNames[outputSelect],
+			firstMoments.meanX,
+			plainStandardError,
+			sqrt(varianceOfOutput));
+		printf(
+			"%s, with control variate: mean $%.2lf (standard error $%.2lf), standard deviation $%.2lf.\n",
+			kOutputVariableNames[outputSelect],
+			controlVariateMean,
+			controlVariateStandardError,
+			sqrt(controlVariateVariance));
+		printf(
+			"The closed-form future value at the average inputs (exact mean $%.2lf) has correlation %.4lf with the output, reducing the variance of the mean by a factor of %.1lf.\n",
+			controlExpectation,
+			correlation,
+			(correlation * correlation < 1.0) ? 1.0 / (1.0 - correlation * correlation) : INFINITY);
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		free(inputVariables[j]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,402 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "correlation.h"
+
+
+/*
+ *	Number of elements processed per block when applying the Cholesky factor. The block keeps the
+ *	inner loop over elements contiguous (and hence vectorizable) while the factor stays in registers.
+ */
+enum
+{
+	kCorrelationBatchBlockLength = 64,
+};
+
+/*
+ *	Table of the standard normal CDF on [-kStandardNormalCdfTableBound, kStandardNormalCdfTableBound],
+ *	with `kStandardNormalCdfTableStepsPerUnit` steps per unit, for linear interpolation. The
+ *	interpolation error is below 5e-7, and the CDF is below 1e-15 outside the table.
+ */
+enum
+{
+	kStandardNormalCdfTableBound		= 8,
+	kStandardNormalCdfTableStepsPerUnit	= 256,
+	kStandardNormalCdfTableLength		= 2 * kStandardNormalCdfTableBound * kStandardNormalCdfTableStepsPerUnit + 1,
+};
+
+/*
+ *	One extra entry past the upper bound, so that positions clamped to the bound need no branch.
+ */
+static double	standardNormalCdfTable[kStandardNormalCdfTableLength + 1];
+
+/**
+ *	@brief	Fill the table of the standard normal CDF.
+ */
+static void
+initStandardNormalCdfTable(void)
+{
+	for (int k = 0; k < kStandardNormalCdfTableLength; k++)
+	{
+		double	z = -kStandardNormalCdfTableBound + (double) k / kStandardNormalCdfTableStepsPerUnit;
+
+		standardNormalCdfTable[k] = 0.5 * erfc(-z * M_SQRT1_2);
+	}
+
+	standardNormalCdfTable[kStandardNormalCdfTableLength] = 1.0;
+
+	return;
+}
+
+/**
+ *	@brief	Compute the lower-triangular Cholesky factor of a correlation matrix.
+ *
+ *	@param	correlation	: The correlation matrix.
+ *	@param	factor		: The factor to populate.
+ *	@return			: `true` if the matrix is positive definite, else `false`.
+ */
+static bool
+computeCholeskyFactor(
+	double	correlation[kInputDistributionIndexMax][kInputDistributionIndexMax],
+	double	factor[kInputDistributionIndexMax][kInputDistributionIndexMax])
+{
+	for (int row = 0; row < kInputDistributionIndexMax; row++)
+	{
+		for (int column = 0; column < kInputDistributionIndexMax; column++)
+		{
+			factor[row][column] = 0.0;
+		}
+	}
+
+	for (int row = 0; row < kInputDistributionIndexMax; row++)
+	{
+		for (int column = 0; column <= row; column++)
+		{
+			double	sum = correlation[row][column];
+
+			for (int k = 0; k < column; k++)
+			{
+				sum -= factor[row][k] * factor[column][k];
+			}
+
+			if (row == column)
+			{
+				if (sum <= 0.0)
+				{
+					return false;
+				}
+
+				factor[row][row] = sqrt(sum);
+			}
+			else
+			{
+				factor[row][column] = sum / factor[column][column];
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ *	@brief	Compute the transform from draws correlated by one lower-triangular factor to draws correlated by another.
+ *
+ *	@param	factor			: The target factor, L.
+ *	@param	innovationFactor	: The factor that the draws are correlated by, L'.
+ *	@param	transform		: The lower-triangular transform to populate, L * inverse(L').
+ */
+static void
+computeInitialStateTransform(
+	double	factor[kInputDistributionIndexMax][kInputDistributionIndexMax],
+	double	innovationFactor[kInputDistributionIndexMax][kInputDistributionIndexMax],
+	double	transform[kInputDistributionIndexMax][kInputDistributionIndexMax])
+{
+	double	inverse[kInputDistributionIndexMax][kInputDistributionIndexMax] = {{0.0}};
+
+	for (int row = 0; row < kInputDistributionIndexMax; row++)
+	{
+		inverse[row][row] = 1.0 / innovationFactor[row][row];
+
+		for (int column = 0; column < row; column++)
+		{
+			double	sum = 0.0;
+
+			for (int k = column; k < row; k++)
+			{
+				sum += innovationFactor[row][k] * inverse[k][column];
+			}
+
+			inverse[row][column] = -sum / innovationFactor[row][row];
+		}
+	}
+
+	for (int row = 0; row < kInputDistributionIndexMax; row++)
+	{
+		for (int column = 0; column < kInputDistributionIndexMax; column++)
+		{
+			double	sum = 0.0;
+
+			for (int k = column; k <= row; k++)
+			{
+				sum += factor[row][k] * inverse[k][column];
+			}
+
+			transform[row][column] = (column <= row) ? sum : 0.0;
+		}
+	}
+
+	return;
+}
+
+CommonConstantReturnType
+computeInputCorrelationCholeskyFactors(InputCorrelation *  inputCorrelation)
+{
+	double	innovationCorrelation[kInputDistributionIndexMax][kInputDistributionIndexMax];
+
+	/*
+	 *	With x[i] = phi * x[i - 1] + sqrt(1 - phi^2) * e[i] per input, stationary inputs have the
+	 *	cross-input correlation rho[j][k] if the innovations e have the correlation
+	 *	rho[j][k] * (1 - phi[j] * phi[k]) / sqrt((1 - phi[j]^2) * (1 - phi[k]^2)), which equals
+	 *	rho[j][k] when the inputs have the same coefficient.
+	 */
+	for (int row = 0; row < kInputDistributionIndexMax; row++)
+	{
+		for (int column = 0; column < kInputDistributionIndexMax; column++)
+		{
+			double	phiRow = inputCorrelation->autocorrelation[row];
+			double	phiColumn = inputCorrelation->autocorrelation[column];
+
+			innovationCorrelation[row][column] = (row == column) ? 1.0 :
+				inputCorrelation->crossCorrelation[row][column] * (1.0 - phiRow * phiColumn) /
+				sqrt((1.0 - phiRow * phiRow) * (1.0 - phiColumn * phiColumn));
+		}
+	}
+
+	/*
+	 *	For every set of free inputs, starting with all of them, factor the matrices with the rows
+	 *	and columns of the fixed inputs replaced by those of the identity. The results are the
+	 *	factors of the sub-matrices of the free inputs, padded with the identity, and are positive
+	 *	definite since those sub-matrices are.
+	 */
+	for (int freeInputs = kInputCorrelationNumberOfFreeInputSets - 1; freeInputs >= 0; freeInputs--)
+	{
+		double	correlation[kInputDistributionIndexMax][kInputDistributionIndexMax];
+		double	innovations[kInputDistributionIndexMax][kInputDistributionIndexMax];
+		double	factor[kInputDistributionIndexMax][kInputDistributionIndexMax];
+
+		for (int row = 0; row < kInputDistributionIndexMax; row++)
+		{
+			for (int column = 0; column < kInputDistributionIndexMax; column++)
+			{
+				bool	isFree = ((freeInputs >> row) & 1) && ((freeInputs >> column) & 1);
+
+				correlation[row][column] = isFree ? inputCorrelation->crossCorrelation[row][column] : (row == column);
+				innovations[row][column] = isFree ? innovationCorrelation[row][column] : (row == column);
+			}
+		}
+
+		if (!computeCholeskyFactor(correlation, factor))
+		{
+			fprintf(stderr, "Error: The cross-input correlation matrix is not positive definite.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!computeCholeskyFactor(innovations, inputCorrelation->choleskyFactors[freeInputs]))
+		{
+			fprintf(stderr, "Error: The cross-input correlations cannot be combined with these autocorrelations, as the correlation matrix of the yearly innovations would not be positive definite.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		computeInitialStateTransform(factor, inputCorrelation->choleskyFactors[freeInputs], inputCorrelation->initialStateTransforms[freeInputs]);
+	}
+
+	initStandardNormalCdfTable();
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+correlateStandardNormalBatch(
+	InputCorrelation *	inputCorrelation,
+	unsigned		freeInputs,
+	size_t			numberOfPaths,
+	size_t			numberOfYearsToRetirement,
+	double *		batch[kInputDistributionIndexMax])
+{
+	double	(*factor)[kInputDistributionIndexMax] = inputCorrelation->choleskyFactors[freeInputs];
+	double	(*transform)[kInputDistributionIndexMax] = inputCorrelation->initialStateTransforms[freeInputs];
+	size_t	numberOfElements = numberOfPaths * numberOfYearsToRetirement;
+
+	/*
+	 *	Cross-input correlation of the innovations: Z = L * U, with the draws of all years of all
+	 *	paths as the columns of U, applied blockwise over columns. Rows are updated from the last
+	 *	to the first, so that row `row` only reads rows that have not been overwritten yet. Rows of
+	 *	fixed inputs, zero coefficients, and unit diagonal entries, as for uncorrelated inputs, are
+	 *	skipped.
+	 */
+	for (size_t blockStart = 0; blockStart < numberOfElements; blockStart += kCorrelationBatchBlockLength)
+	{
+		size_t	blockEnd = blockStart + kCorrelationBatchBlockLength;
+
+		if (blockEnd > numberOfElements)
+		{
+			blockEnd = numberOfElements;
+		}
+
+		for (int row = kInputDistributionIndexMax - 1; row >= 0; row--)
+		{
+			double *	output = batch[row];
+
+			if (!((freeInputs >> row) & 1u))
+			{
+				continue;
+			}
+
+			if (factor[row][row] != 1.0)
+			{
+				for (size_t element = blockStart; element < blockEnd; element++)
+				{
+					output[element] *= factor[row][row];
+				}
+			}
+
+			for (int k = 0; k < row; k++)
+			{
+				double		coefficient = factor[row][k];
+				double *	input = batch[k];
+
+				if (coefficient == 0.0)
+				{
+					continue;
+				}
+
+				for (size_t element = blockStart; element < blockEnd; element++)
+				{
+					output[element] += coefficient * input[element];
+				}
+			}
+		}
+	}
+
+	/*
+	 *	The first year of each path is the initial state of the AR(1) processes, rather than an
+	 *	innovation, so it is correlated by the factor of the cross-input correlation matrix itself.
+	 *	Rows are updated from the last to the first, as above.
+	 */
+	for (size_t path = 0; path < numberOfPaths; path++)
+	{
+		size_t	element = path * numberOfYearsToRetirement;
+
+		for (int row = kInputDistributionIndexMax - 1; row >= 0; row--)
+		{
+			double	value;
+
+			if (!((freeInputs >> row) & 1u))
+			{
+				continue;
+			}
+
+			value = transform[row][row] * batch[row][element];
+
+			for (int k = 0; k < row; k++)
+			{
+				if (transform[row][k] != 0.0)
+				{
+					value += transform[row][k] * batch[k][element];
+				}
+			}
+
+			batch[row][element] = value;
+		}
+	}
+
+	/*
+	 *	Serial correlation: x[0] = z[0], x[i] = phi * x[i - 1] + sqrt(1 - phi^2) * z[i], along the
+	 *	years of each path. This is the stationary AR(1) process with unit variance, so marginals
+	 *	are unaffected.
+	 */
+	for (int input = 0; input < kInputDistributionIndexMax; input++)
+	{
+		double	autocorrelation = inputCorrelation->autocorrelation[input];
+		double	innovationScale = sqrt(1.0 - autocorrelation * autocorrelation);
+
+		if ((autocorrelation == 0.0) || !((freeInputs >> input) & 1u))
+		{
+			continue;
+		}
+
+		/*
+		 *	The paths are independent, so they are interleaved to overlap their recurrences.
+		 */
+		for (size_t year = 1; year < numberOfYearsToRetirement; year++)
+		{
+			double *	series = &batch[input][year];
+
+			for (size_t path = 0; path < numberOfPaths; path++)
+			{
+				size_t	element = path * numberOfYearsToRetirement;
+
+				series[element] = autocorrelation * series[element - 1] + innovationScale * series[element];
+			}
+		}
+	}
+
+	return;
+}
+
+double
+mapStandardNormalToUniform(
+	double	standardNormal,
+	double	min,
+	double	max)
+{
+	return min + (max - min) * 0.5 * erfc(-standardNormal * M_SQRT1_2);
+}
+
+void
+mapStandardNormalBatchToUniform(
+	double *	values,
+	size_t		numberOfValues,
+	double		min,
+	double		max)
+{
+	for (size_t n = 0; n < numberOfValues; n++)
+	{
+		double	position = (values[n] + kStandardNormalCdfTableBound) * kStandardNormalCdfTableStepsPerUnit;
+		int	k;
+		double	t;
+
+		position = (position > 0.0) ? position : 0.0;
+		position = (position < kStandardNormalCdfTableLength - 1) ? position : kStandardNormalCdfTableLength - 1;
+		k = (int) position;
+		t = position - (double) k;
+
+		values[n] = min + (max - min) * (standardNormalCdfTable[k] + t * (standardNormalCdfTable[k + 1] - standardNormalCdfTable[k]));
+	}
+
+	return;
+}
@@ -0,0 +1,93 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Compute the Cholesky factors of the cross-input correlation matrix, one per set of free inputs.
+ *
+ *	The yearly innovations of the AR(1) filters are correlated so that the inputs of every year,
+ *	not only the first, have the given cross-input correlations, also when the inputs have
+ *	different autocorrelations.
+ *
+ *	Also fills the table used by `mapStandardNormalBatchToUniform()`, so it must be called before
+ *	any sampling starts.
+ *
+ *	@param	inputCorrelation	: Pointer to the correlation specification. On success, its `choleskyFactors` are populated.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError` (a matrix not positive definite).
+ */
+CommonConstantReturnType	computeInputCorrelationCholeskyFactors(InputCorrelation *  inputCorrelation);
+
+/**
+ *	@brief	Correlate a batch of independent standard normal draws of several paths in place.
+ *
+ *	Each year's vector of draws is multiplied by the lower-triangular Cholesky factor of the
+ *	correlation matrix of the innovations of the free inputs, or, for the first year, of their
+ *	cross-input correlation matrix, after which each free input is passed through its AR(1)
+ *	filter across the years of each path. The filter is scaled so that every
+ *	element keeps unit marginal variance. The draws of fixed inputs are neither read nor written.
+ *
+ *	@param	inputCorrelation		: Pointer to the correlation specification.
+ *	@param	freeInputs			: Bit mask of the inputs that are sampled, by `InputDistributionIndex`.
+ *	@param	numberOfPaths			: Number of paths in the batch.
+ *	@param	numberOfYearsToRetirement	: Number of years per path.
+ *	@param	batch				: Per-input arrays of independent standard normal draws, path after path, overwritten with correlated draws.
+ */
+void	correlateStandardNormalBatch(
+		InputCorrelation *	inputCorrelation,
+		unsigned		freeInputs,
+		size_t			numberOfPaths,
+		size_t			numberOfYearsToRetirement,
+		double *		batch[kInputDistributionIndexMax]);
+
+/**
+ *	@brief	Map a standard normal draw to a uniform marginal via the normal CDF.
+ *
+ *	@param	standardNormal	: The standard normal draw.
+ *	@param	min		: Lower bound of the uniform marginal.
+ *	@param	max		: Upper bound of the uniform marginal.
+ *	@return			: The corresponding draw from Uniform(min, max).
+ */
+double	mapStandardNormalToUniform(
+		double	standardNormal,
+		double	min,
+		double	max);
+
+/**
+ *	@brief	Map an array of standard normal samples to a uniform marginal in place.
+ *
+ *	Like `mapStandardNormalToUniform()`, but interpolates the normal CDF from a table instead of
+ *	calling `erfc()`, so it only applies to samples, not to UxHw distributions.
+ *
+ *	@param	values		: The standard normal samples, overwritten with samples from Uniform(min, max).
+ *	@param	numberOfValues	: Number of samples.
+ *	@param	min		: Lower bound of the uniform marginal.
+ *	@param	max		: Upper bound of the uniform marginal.
+ */
+void	mapStandardNormalBatchToUniform(
+		double *	values,
+		size_t		numberOfValues,
+		double		min,
+		double		max);
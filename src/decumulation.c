@@ -0,0 +1,313 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "decumulation.h"
+#include "fusedKernel.h"
+#include "kernel.h"
+#include "parallelMonteCarlo.h"
+#include "sampling.h"
+#include "specializedKernels.h"
+
+
+/**
+ *	An input of the years of retirement: a constant set from the command line, or a sample of its
+ *	default uniform distribution.
+ */
+typedef struct
+{
+	InputDistributionIndex	input;
+	bool			isConstant;
+	double			constant;
+} DecumulationInput;
+
+static void
+initDecumulationInput(
+	DecumulationInput *	decumulationInput,
+	CommandLineArguments *	arguments,
+	InputDistributionIndex	input)
+{
+	decumulationInput->input = input;
+	decumulationInput->isConstant = arguments->isInputVariableSet[input];
+	decumulationInput->constant = 0.0;
+
+	if (decumulationInput->isConstant)
+	{
+		sscanf(arguments->inputVariablesUxStrings[input], "%lf", &decumulationInput->constant);
+	}
+
+	return;
+}
+
+static double
+drawDecumulationInput(const DecumulationInput *  decumulationInput, SamplingStream *  stream)
+{
+	if (decumulationInput->isConstant)
+	{
+		return decumulationInput->constant;
+	}
+
+	return samplingStreamUniform(stream, kDefaultInputDistributionMin[decumulationInput->input], kDefaultInputDistributionMax[decumulationInput->input]);
+}
+
+/**
+ *	@brief	Return the smallest number of years of withdrawals whose cumulative count of ruined paths
+ *		exceeds the given rank.
+ */
+static int
+findYearsOfWithdrawalsOfRank(const size_t *  histogram, int  horizon, size_t  rank)
+{
+	size_t	cumulativeCount = 0;
+
+	for (int year = 0; year < horizon; year++)
+	{
+		cumulativeCount += histogram[year];
+
+		if (cumulativeCount > rank)
+		{
+			return year;
+		}
+	}
+
+	return horizon;
+}
+
+CommonConstantReturnType
+runDecumulationMode(CommandLineArguments *  arguments)
+{
+	size_t			numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	int			numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+	int			horizon = arguments->decumulationYears;
+	OutputDistributionIndex	outputSelect = arguments->common.outputSelect;
+	bool			isTaxed = (outputSelect == kOutputDistributionIndexFutureValueTaxed);
+	double *		inputVariables[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	CalculateOutputFunction	calculateOutputFunction;
+	FusedKernel		fusedKernel;
+	DecumulationInput	interestRate;
+	DecumulationInput	taxRate;
+	SamplingStream		stream;
+	double *		balances;
+	double *		withdrawals;
+	double *		growthRates;
+	size_t *		pathIndices;
+	unsigned char *		isRuined;
+	int *			yearsOfWithdrawals;
+	size_t *		ruinHistogram;
+	size_t			numberOfRuinedPaths;
+	size_t			numberOfPathYears = 0;
+	double			sumOfYearsOfWithdrawalsOfRuinedPaths = 0.0;
+	double			sumOfFinalBalancesOfSurvivingPaths = 0.0;
+	double			probabilityOfRuin;
+	double			meanYearsOfWithdrawalsOfRuinedPaths;
+	double			cpuTimeUsedInSeconds;
+	clock_t			start;
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		inputVariables[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	balances = (double *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(double), __FILE__, __LINE__);
+	withdrawals = (double *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(double), __FILE__, __LINE__);
+	growthRates = (double *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(double), __FILE__, __LINE__);
+	pathIndices = (size_t *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(size_t), __FILE__, __LINE__);
+	isRuined = (unsigned char *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(unsigned char), __FILE__, __LINE__);
+	yearsOfWithdrawals = (int *) checkedMalloc(kParallelMonteCarloBlockSize * sizeof(int), __FILE__, __LINE__);
+	ruinHistogram = (size_t *) checkedMalloc((horizon + 1) * sizeof(size_t), __FILE__, __LINE__);
+
+	for (int year = 0; year <= horizon; year++)
+	{
+		ruinHistogram[year] = 0;
+	}
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, numberOfYearsToRetirement);
+
+	if (arguments->isFusedKernelEnabled)
+	{
+		initFusedKernel(&fusedKernel, arguments);
+	}
+
+	initDecumulationInput(&interestRate, arguments, kInputDistributionIndexCompoundedAnnualInterestRate);
+	initDecumulationInput(&taxRate, arguments, kInputDistributionIndexAssumedTaxRateOnInterest);
+
+	start = clock();
+
+	/*
+	 *	Batch `b` draws from sampling stream `b`, first the accumulation phase of all its paths, in
+	 *	the order of NUMA-aware mode, so that the balances at retirement are the samples of `-Q`
+	 *	with the same seed, and then the years of retirement.
+	 */
+	for (size_t batchStart = 0; batchStart < numberOfIterations; batchStart += kParallelMonteCarloBlockSize)
+	{
+		size_t	numberOfPaths = (numberOfIterations - batchStart < kParallelMonteCarloBlockSize) ? numberOfIterations - batchStart : kParallelMonteCarloBlockSize;
+		size_t	numberOfActivePaths = numberOfPaths;
+
+		initSamplingStream(&stream, arguments->seed, batchStart / kParallelMonteCarloBlockSize);
+
+		for (size_t j = 0; j < numberOfPaths; j++)
+		{
+			if (arguments->isFusedKernelEnabled)
+			{
+				runFusedKernel(&fusedKernel, &stream, outputDistributions, NULL);
+			}
+			else
+			{
+				setInputVariablesFromStream(arguments, &stream, inputVariables);
+				calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+			}
+
+			balances[j] = outputDistributions[outputSelect];
+			withdrawals[j] = arguments->isDecumulationWithdrawalSet ?
+						arguments->decumulationWithdrawal :
+						balances[j] * (kDefaultDecumulationWithdrawalPercentage / 100);
+			pathIndices[j] = j;
+			yearsOfWithdrawals[j] = horizon;
+		}
+
+		/*
+		 *	The growth of a year of retirement is that of the selected output during accumulation.
+		 */
+		for (int year = 0; (year < horizon) && (numberOfActivePaths > 0); year++)
+		{
+			for (size_t j = 0; j < numberOfActivePaths; j++)
+			{
+				double	rate = drawDecumulationInput(&interestRate, &stream) / 100;
+
+				growthRates[j] = isTaxed ? rate * (1.0 - (drawDecumulationInput(&taxRate, &stream) / 100)) : rate;
+			}
+
+			numberOfPathYears += numberOfActivePaths;
+			numberOfActivePaths = calculateDecumulationYear(
+						numberOfActivePaths,
+						balances,
+						withdrawals,
+						growthRates,
+						pathIndices,
+						isRuined,
+						year,
+						yearsOfWithdrawals);
+		}
+
+		for (size_t j = 0; j < numberOfPaths; j++)
+		{
+			ruinHistogram[yearsOfWithdrawals[j]]++;
+		}
+
+		for (size_t j = 0; j < numberOfActivePaths; j++)
+		{
+			sumOfFinalBalancesOfSurvivingPaths += balances[j];
+		}
+	}
+
+	numberOfRuinedPaths = numberOfIterations - ruinHistogram[horizon];
+
+	for (int year = 0; year < horizon; year++)
+	{
+		sumOfYearsOfWithdrawalsOfRuinedPaths += (double) year * (double) ruinHistogram[year];
+	}
+
+	probabilityOfRuin = (double) numberOfRuinedPaths / (double) numberOfIterations;
+	meanYearsOfWithdrawalsOfRuinedPaths = (numberOfRuinedPaths > 0) ? sumOfYearsOfWithdrawalsOfRuinedPaths / (double) numberOfRuinedPaths : (double) horizon;
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %lf %" PRIu64 "\n", probabilityOfRuin, meanYearsOfWithdrawalsOfRuinedPaths, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		if (arguments->isDecumulationWithdrawalSet)
+		{
+			printf("%s, then %d years of withdrawals of $%.2lf per year:\n", kOutputVariableNames[outputSelect], horizon, arguments->decumulationWithdrawal);
+		}
+		else
+		{
+			printf(
+				"%s, then %d years of withdrawals of %.1lf%% of the balance at retirement per year:\n",
+				kOutputVariableNames[outputSelect],
+				horizon,
+				kDefaultDecumulationWithdrawalPercentage);
+		}
+
+		printf(
+			"P(ruin within %d years) = %lf (standard error %lf).\n",
+			horizon,
+			probabilityOfRuin,
+			sqrt(probabilityOfRuin * (1.0 - probabilityOfRuin) / (double) numberOfIterations));
+
+		if (numberOfRuinedPaths > 0)
+		{
+			printf(
+				"Years of withdrawals before ruin: mean %.2lf, 5th percentile %d, median %d, 95th percentile %d.\n",
+				meanYearsOfWithdrawalsOfRuinedPaths,
+				findYearsOfWithdrawalsOfRank(ruinHistogram, horizon, (size_t)(0.05 * (double)(numberOfRuinedPaths - 1))),
+				findYearsOfWithdrawalsOfRank(ruinHistogram, horizon, (size_t)(0.5 * (double)(numberOfRuinedPaths - 1))),
+				findYearsOfWithdrawalsOfRank(ruinHistogram, horizon, (size_t)(0.95 * (double)(numberOfRuinedPaths - 1))));
+			printf("Distribution of the years of withdrawals before ruin:\n");
+
+			for (int year = 0; year < horizon; year++)
+			{
+				if (ruinHistogram[year] > 0)
+				{
+					printf("\t%d years: %zu paths (%lf)\n", year, ruinHistogram[year], (double) ruinHistogram[year] / (double) numberOfIterations);
+				}
+			}
+		}
+
+		if (ruinHistogram[horizon] > 0)
+		{
+			printf("Mean balance of the paths not ruined after %d years: $%.2lf.\n", horizon, sumOfFinalBalancesOfSurvivingPaths / (double) ruinHistogram[horizon]);
+		}
+
+		printf(
+			"Simulated %zu of %zu path-years of retirement (%.1lf%%), as ruined paths stop.\n",
+			numberOfPathYears,
+			numberOfIterations * (size_t) horizon,
+			100.0 * (double) numberOfPathYears / ((double) numberOfIterations * (double) horizon));
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		free(inputVariables[j]);
+	}
+
+	free(ruinHistogram);
+	free(yearsOfWithdrawals);
+	free(isRuined);
+	free(pathIndices);
+	free(growthRates);
+	free(withdrawals);
+	free(balances);
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,132 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <uxhw.h>
+#include "fusedKernel.h"
+
+
+void
+initFusedKernel(
+	FusedKernel *		fusedKernel,
+	CommandLineArguments *	arguments)
+{
+	bool	calculateAllOutputs = (arguments->common.outputSelect == kOutputDistributionIndexMax);
+
+	fusedKernel->numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		fusedKernel->isInputConstant[j] = arguments->isInputVariableSet[j];
+		fusedKernel->inputConstant[j] = 0.0;
+
+		/*
+		 *	Fused mode only runs in Monte Carlo mode, where inputs set from the command line are
+		 *	plain numbers, so they are parsed once instead of once per year of every path.
+		 */
+		if (fusedKernel->isInputConstant[j])
+		{
+			sscanf(arguments->inputVariablesUxStrings[j], "%lf", &fusedKernel->inputConstant[j]);
+		}
+	}
+
+	fusedKernel->isFutureValueTaxedSelected = calculateAllOutputs || (arguments->common.outputSelect == kOutputDistributionIndexFutureValueTaxed);
+	fusedKernel->isFutureValueTaxedWithdrawalSelected = calculateAllOutputs || (arguments->common.outputSelect == kOutputDistributionIndexFutureValueTaxedWithdrawal);
+
+	return;
+}
+
+/**
+ *	@brief	Draw one input of one year: its constant, or a sample of its default distribution.
+ */
+static inline double
+drawFusedInput(const FusedKernel *  fusedKernel, SamplingStream *  stream, InputDistributionIndex  input)
+{
+	if (fusedKernel->isInputConstant[input])
+	{
+		return fusedKernel->inputConstant[input];
+	}
+
+	if (stream != NULL)
+	{
+		return samplingStreamUniform(stream, kDefaultInputDistributionMin[input], kDefaultInputDistributionMax[input]);
+	}
+
+	return UxHwDoubleUniformDist(kDefaultInputDistributionMin[input], kDefaultInputDistributionMax[input]);
+}
+
+void
+runFusedKernel(
+	const FusedKernel *	fusedKernel,
+	SamplingStream *	stream,
+	double *		outputDistributions,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	double	futureValueTaxed = 0.0;
+	double	futureValueTaxedWithdrawal = 0.0;
+
+	for (int i = 0; i < fusedKernel->numberOfYearsToRetirement; i++)
+	{
+		double	totalAnnualContributionToAccount = drawFusedInput(fusedKernel, stream, kInputDistributionIndexTotalAnnualContributionToAccount);
+		double	compoundedAnnualInterestRate = drawFusedInput(fusedKernel, stream, kInputDistributionIndexCompoundedAnnualInterestRate);
+		double	assumedTaxRateOnInterest = drawFusedInput(fusedKernel, stream, kInputDistributionIndexAssumedTaxRateOnInterest);
+		double	withdrawalRate = drawFusedInput(fusedKernel, stream, kInputDistributionIndexWithdrawalRate);
+
+		/*
+		 *	Same expressions as `calculateFutureValueTaxed()` and `calculateFutureValueTaxedWithdrawal()`.
+		 */
+		if (fusedKernel->isFutureValueTaxedSelected)
+		{
+			futureValueTaxed =
+				(futureValueTaxed + totalAnnualContributionToAccount) *
+				(1.0 + ((compoundedAnnualInterestRate / 100) * (1.0 - (assumedTaxRateOnInterest / 100))));
+		}
+
+		if (fusedKernel->isFutureValueTaxedWithdrawalSelected)
+		{
+			futureValueTaxedWithdrawal =
+				(futureValueTaxedWithdrawal + totalAnnualContributionToAccount * (1.0 - (withdrawalRate / 100))) *
+				(1.0 + (compoundedAnnualInterestRate / 100));
+		}
+
+		if (inputVariables != NULL)
+		{
+			inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount][i] = totalAnnualContributionToAccount;
+			inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate][i] = compoundedAnnualInterestRate;
+			inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest][i] = assumedTaxRateOnInterest;
+			inputVariables[kInputDistributionIndexWithdrawalRate][i] = withdrawalRate;
+		}
+	}
+
+	if (fusedKernel->isFutureValueTaxedSelected)
+	{
+		outputDistributions[kOutputDistributionIndexFutureValueTaxed] = futureValueTaxed;
+	}
+
+	if (fusedKernel->isFutureValueTaxedWithdrawalSelected)
+	{
+		outputDistributions[kOutputDistributionIndexFutureValueTaxedWithdrawal] = futureValueTaxedWithdrawal;
+	}
+
+	return;
+}
@@ -0,0 +1,72 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "sampling.h"
+#include "utilities.h"
+
+
+/**
+ *	Loop-invariant state of the fused kernel: the constant inputs, parsed once, and the selected
+ *	outputs. The other inputs are drawn from their default uniform distributions.
+ */
+typedef struct
+{
+	int	numberOfYearsToRetirement;
+	bool	isInputConstant[kInputDistributionIndexMax];
+	double	inputConstant[kInputDistributionIndexMax];
+	bool	isFutureValueTaxedSelected;
+	bool	isFutureValueTaxedWithdrawalSelected;
+} FusedKernel;
+
+/**
+ *	@brief	Prepare the fused kernel for the arguments of a run.
+ *
+ *	@param	fusedKernel	: Pointer to the fused kernel to initialize.
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ */
+void	initFusedKernel(
+		FusedKernel *		fusedKernel,
+		CommandLineArguments *	arguments);
+
+/**
+ *	@brief	Draw the inputs of one path and calculate the selected outputs, in a single pass over the
+ *		years.
+ *
+ *	Each year's four inputs are drawn, in the order of `setInputVariablesFromStream()`, and used
+ *	at once to advance the future values, so they stay in registers instead of making a round trip
+ *	through the per-year input arrays. For the same stream, the outputs are identical to those of
+ *	`setInputVariablesFromStream()` followed by `calculateOutput()`.
+ *
+ *	@param	fusedKernel		: Pointer to the fused kernel.
+ *	@param	stream			: Sampling stream, or `NULL` to use UxHw calls.
+ *	@param	outputDistributions	: Array to store the selected outputs, indexed by `OutputDistributionIndex`.
+ *	@param	inputVariables		: The input variables to also store the drawn inputs in, e.g., for
+ *					  JSON output, or `NULL` to not store them.
+ */
+void	runFusedKernel(
+		const FusedKernel *	fusedKernel,
+		SamplingStream *	stream,
+		double *		outputDistributions,
+		double *		inputVariables[kInputDistributionIndexMax]);
@@ -0,0 +1,406 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uxhw.h>
+#include "household.h"
+#include "kernel.h"
+
+
+static const char	kHouseholdAccountTableHeader[] = "account_type,number_of_years_to_retirement,total_annual_contribution_min,total_annual_contribution_max";
+
+/**
+ *	@brief	Parse one row of the household accounts CSV file into the table.
+ *
+ *	@param	line			: The row to parse.
+ *	@param	householdAccountTable	: Pointer to the table.
+ *	@param	account			: Index of the account to populate.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseHouseholdAccountRow(
+	char *			line,
+	HouseholdAccountTable *	householdAccountTable,
+	size_t			account)
+{
+	char *	cursor = line;
+	char *	end;
+	long	accountType;
+	long	numberOfYearsToRetirement;
+	double	contributionMin;
+	double	contributionMax;
+
+	errno = 0;
+	accountType = strtol(cursor, &end, 10);
+	if ((end == cursor) || (*end != ',') || (accountType < 0) || (accountType >= kOutputDistributionIndexMax))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	cursor = end + 1;
+	numberOfYearsToRetirement = strtol(cursor, &end, 10);
+	if ((end == cursor) || (*end != ',') || (numberOfYearsToRetirement < 0) || (numberOfYearsToRetirement > INT32_MAX))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	cursor = end + 1;
+	contributionMin = strtod(cursor, &end);
+	if ((end == cursor) || (*end != ','))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	cursor = end + 1;
+	contributionMax = strtod(cursor, &end);
+	if ((end == cursor) || (strspn(end, " \t\r\n") != strlen(end)) || (errno != 0) || (contributionMax < contributionMin))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	householdAccountTable->accountType[account] = (OutputDistributionIndex) accountType;
+	householdAccountTable->numberOfYearsToRetirement[account] = (int) numberOfYearsToRetirement;
+	householdAccountTable->totalAnnualContributionMin[account] = contributionMin;
+	householdAccountTable->totalAnnualContributionMax[account] = contributionMax;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief	Double the capacity of all columns of the household accounts table.
+ *
+ *	@param	householdAccountTable	: Pointer to the table.
+ *	@param	capacity		: Pointer to the capacity of the columns, updated on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+growHouseholdAccountTable(
+	HouseholdAccountTable *	householdAccountTable,
+	size_t *		capacity)
+{
+	size_t				newCapacity = (*capacity == 0) ? 4 : 2 * (*capacity);
+	OutputDistributionIndex *	accountType;
+	int *				numberOfYearsToRetirement;
+	double *			totalAnnualContributionMin;
+	double *			totalAnnualContributionMax;
+
+	accountType = realloc(householdAccountTable->accountType, newCapacity * sizeof(OutputDistributionIndex));
+	if (accountType == NULL)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	householdAccountTable->accountType = accountType;
+
+	numberOfYearsToRetirement = realloc(householdAccountTable->numberOfYearsToRetirement, newCapacity * sizeof(int));
+	if (numberOfYearsToRetirement == NULL)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	householdAccountTable->numberOfYearsToRetirement = numberOfYearsToRetirement;
+
+	totalAnnualContributionMin = realloc(householdAccountTable->totalAnnualContributionMin, newCapacity * sizeof(double));
+	if (totalAnnualContributionMin == NULL)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	householdAccountTable->totalAnnualContributionMin = totalAnnualContributionMin;
+
+	totalAnnualContributionMax = realloc(householdAccountTable->totalAnnualContributionMax, newCapacity * sizeof(double));
+	if (totalAnnualContributionMax == NULL)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	householdAccountTable->totalAnnualContributionMax = totalAnnualContributionMax;
+
+	*capacity = newCapacity;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+loadHouseholdAccountTable(
+	const char *		path,
+	HouseholdAccountTable *	householdAccountTable)
+{
+	char		line[kCommonConstantMaxCharsPerLine];
+	size_t		capacity = 0;
+	FILE *		file = fopen(path, "r");
+
+	memset(householdAccountTable, 0, sizeof(HouseholdAccountTable));
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open household accounts file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fgets(line, sizeof(line), file) == NULL) || (strncmp(line, kHouseholdAccountTableHeader, strlen(kHouseholdAccountTableHeader)) != 0))
+	{
+		fprintf(stderr, "Error: Household accounts file \"%s\" must start with the header \"%s\".\n", path, kHouseholdAccountTableHeader);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		if (strspn(line, " \t\r\n") == strlen(line))
+		{
+			continue;
+		}
+
+		if ((householdAccountTable->numberOfAccounts == capacity) &&
+			(growHouseholdAccountTable(householdAccountTable, &capacity) != kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(stderr, "Error: Could not allocate memory for the household accounts table.\n");
+			freeHouseholdAccountTable(householdAccountTable);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (parseHouseholdAccountRow(line, householdAccountTable, householdAccountTable->numberOfAccounts) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: Malformed row %zu in household accounts file \"%s\".\n", householdAccountTable->numberOfAccounts + 1, path);
+			freeHouseholdAccountTable(householdAccountTable);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (householdAccountTable->numberOfYearsToRetirement[householdAccountTable->numberOfAccounts] > householdAccountTable->maxNumberOfYearsToRetirement)
+		{
+			householdAccountTable->maxNumberOfYearsToRetirement = householdAccountTable->numberOfYearsToRetirement[householdAccountTable->numberOfAccounts];
+		}
+
+		householdAccountTable->numberOfAccounts++;
+	}
+
+	fclose(file);
+
+	if (householdAccountTable->numberOfAccounts == 0)
+	{
+		fprintf(stderr, "Error: Household accounts file \"%s\" has no accounts.\n", path);
+		freeHouseholdAccountTable(householdAccountTable);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+freeHouseholdAccountTable(HouseholdAccountTable *  householdAccountTable)
+{
+	free(householdAccountTable->accountType);
+	free(householdAccountTable->numberOfYearsToRetirement);
+	free(householdAccountTable->totalAnnualContributionMin);
+	free(householdAccountTable->totalAnnualContributionMax);
+	memset(householdAccountTable, 0, sizeof(HouseholdAccountTable));
+
+	return;
+}
+
+double
+calculateHouseholdFutureValue(
+	HouseholdAccountTable *	householdAccountTable,
+	int			periodsPerYear,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	double *	totalAnnualContributionToAccount = inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount];
+	double		householdFutureValue = 0.0;
+
+	for (size_t account = 0; account < householdAccountTable->numberOfAccounts; account++)
+	{
+		int		numberOfYearsToRetirement = householdAccountTable->numberOfYearsToRetirement[account];
+		int		firstYear = householdAccountTable->maxNumberOfYearsToRetirement - numberOfYearsToRetirement;
+		double		contributionMin = householdAccountTable->totalAnnualContributionMin[account];
+		double		contributionMax = householdAccountTable->totalAnnualContributionMax[account];
+		double *	accountInputVariables[kInputDistributionIndexMax];
+
+		for (int i = firstYear; i < householdAccountTable->maxNumberOfYearsToRetirement; i++)
+		{
+			totalAnnualContributionToAccount[i] = (contributionMin == contributionMax) ? contributionMin : UxHwDoubleUniformDist(contributionMin, contributionMax);
+		}
+
+		/*
+		 *	Align the account's horizon with the end of the shared input arrays.
+		 */
+		for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			accountInputVariables[j] = inputVariables[j] + firstYear;
+		}
+
+		if (householdAccountTable->accountType[account] == kOutputDistributionIndexFutureValueTaxed)
+		{
+			householdFutureValue += calculateFutureValueTaxedCompounded(numberOfYearsToRetirement, periodsPerYear, accountInputVariables);
+		}
+		else
+		{
+			householdFutureValue += calculateFutureValueTaxedWithdrawalCompounded(numberOfYearsToRetirement, periodsPerYear, accountInputVariables);
+		}
+	}
+
+	return householdFutureValue;
+}
+
+CommonConstantReturnType
+runHouseholdMode(CommandLineArguments *  arguments)
+{
+	HouseholdAccountTable	householdAccountTable;
+	double *		inputVariables[kInputDistributionIndexMax];
+	double *		monteCarloOutputSamples = NULL;
+	double			householdFutureValue = 0.0;
+	double			benchmarkOutput = 0.0;
+	clock_t			start = 0;
+	clock_t			end = 0;
+	double			cpuTimeUsedInSeconds = 0.0;
+	CommonConstantReturnType	status = kCommonConstantReturnTypeSuccess;
+	const char *		outputVariableName = "householdFutureValue";
+	const char *		outputVariableDescription = "Future value, summed over all accounts of the household";
+
+	if (loadHouseholdAccountTable(arguments->householdFilePath, &householdAccountTable) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	The shared market and tax inputs span the longest horizon.
+	 */
+	arguments->numberOfYearsToRetirement = householdAccountTable.maxNumberOfYearsToRetirement;
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		inputVariables[i] = (double *) checkedMalloc(arguments->numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		monteCarloOutputSamples = (double *) checkedMalloc(
+			arguments->common.numberOfMonteCarloIterations * sizeof(double),
+			__FILE__,
+			__LINE__);
+	}
+
+	if ((arguments->common.isTimingEnabled) || (arguments->common.isBenchmarkingMode))
+	{
+		start = clock();
+	}
+
+	for (size_t i = 0; i < arguments->common.numberOfMonteCarloIterations; ++i)
+	{
+		setInputVariables(arguments, inputVariables);
+
+		householdFutureValue = calculateHouseholdFutureValue(&householdAccountTable, arguments->periodsPerYear, inputVariables);
+
+		if (arguments->common.isMonteCarloMode)
+		{
+			monteCarloOutputSamples[i] = householdFutureValue;
+		}
+		else if (arguments->common.isBenchmarkingMode)
+		{
+			benchmarkOutput = householdFutureValue;
+		}
+	}
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		benchmarkOutput = calculateMeanAndVarianceOfDoubleSamples(
+					monteCarloOutputSamples,
+					arguments->common.numberOfMonteCarloIterations).mean;
+	}
+
+	if ((arguments->common.isTimingEnabled) || (arguments->common.isBenchmarkingMode))
+	{
+		end = clock();
+		cpuTimeUsedInSeconds = ((double)(end - start)) / CLOCKS_PER_SEC;
+	}
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %" PRIu64 "\n", benchmarkOutput, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		double *	pointerToValueToPrint = arguments->common.isMonteCarloMode ? monteCarloOutputSamples : &householdFutureValue;
+
+		if (arguments->common.isOutputJSONMode)
+		{
+			JSONVariable	jsonVariable;
+
+			snprintf(jsonVariable.variableSymbol, kCommonConstantMaxCharsPerJSONVariableSymbol, "%s", outputVariableName);
+			snprintf(jsonVariable.variableDescription, kCommonConstantMaxCharsPerJSONVariableDescription, "%s", outputVariableDescription);
+			jsonVariable.values = (JSONVariablePointer){ .asDouble = pointerToValueToPrint };
+			jsonVariable.type = kJSONVariableTypeDouble;
+			jsonVariable.size = arguments->common.numberOfMonteCarloIterations;
+
+			printJSONVariables(&jsonVariable, 1, "Household output variables");
+		}
+		else
+		{
+			for (size_t i = 0; i < arguments->common.numberOfMonteCarloIterations; ++i)
+			{
+				printf("%s (%zu accounts) %s is $%.2lf.\n", outputVariableDescription, householdAccountTable.numberOfAccounts, outputVariableName, pointerToValueToPrint[i]);
+			}
+		}
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		saveMonteCarloDoubleDataToDataDotOutFile(
+			monteCarloOutputSamples,
+			(uint64_t)(cpuTimeUsedInSeconds * 1000000),
+			arguments->common.numberOfMonteCarloIterations);
+		free(monteCarloOutputSamples);
+	}
+	else if (arguments->common.isWriteToFileEnabled)
+	{
+		if (writeOutputDoubleDistributionsToCSV(
+			arguments->common.outputFilePath,
+			&householdFutureValue,
+			&outputVariableName,
+			1))
+		{
+			fprintf(stderr, "Error: Could not write to output CSV file \"%s\".\n", arguments->common.outputFilePath);
+			status = kCommonConstantReturnTypeError;
+		}
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		free(inputVariables[i]);
+	}
+
+	freeHouseholdAccountTable(&householdAccountTable);
+
+	return status;
+}
@@ -0,0 +1,87 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	Parameters of the accounts of a household, stored as a structure of arrays indexed by account.
+ */
+typedef struct
+{
+	size_t				numberOfAccounts;
+	int				maxNumberOfYearsToRetirement;
+	OutputDistributionIndex *	accountType;
+	int *				numberOfYearsToRetirement;
+	double *			totalAnnualContributionMin;
+	double *			totalAnnualContributionMax;
+} HouseholdAccountTable;
+
+/**
+ *	@brief	Load the household accounts from a CSV file.
+ *
+ *	The file has the header `account_type,number_of_years_to_retirement,total_annual_contribution_min,total_annual_contribution_max`
+ *	followed by one row per account. The account type is the index of the output whose recurrence
+ *	models the account (0: taxable, 1: tax-free with taxed withdrawal).
+ *
+ *	@param	path			: Path to the household accounts CSV file.
+ *	@param	householdAccountTable	: Pointer to the table to populate.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	loadHouseholdAccountTable(
+					const char *		path,
+					HouseholdAccountTable *	householdAccountTable);
+
+/**
+ *	@brief	Free the allocations of a household accounts table.
+ *
+ *	@param	householdAccountTable	: Pointer to the table to free.
+ */
+void	freeHouseholdAccountTable(HouseholdAccountTable *  householdAccountTable);
+
+/**
+ *	@brief	Calculate the total future value of all accounts of a household for one path.
+ *
+ *	All accounts retire at the end of the longest horizon and share the interest, withdrawal and
+ *	tax rates in `inputVariables`, which span `maxNumberOfYearsToRetirement` years: an account with
+ *	a horizon of `n` years sees the last `n` of them. Contributions are sampled per account into
+ *	the contribution array of `inputVariables`, which is overwritten.
+ *
+ *	@param	householdAccountTable	: Pointer to the household accounts table.
+ *	@param	periodsPerYear		: Number of compounding periods per year.
+ *	@param	inputVariables		: The shared input variables of the path.
+ *	@return				: The household future value.
+ */
+double	calculateHouseholdFutureValue(
+		HouseholdAccountTable *	householdAccountTable,
+		int			periodsPerYear,
+		double *		inputVariables[kInputDistributionIndexMax]);
+
+/**
+ *	@brief	Run the household mode end to end: sampling, kernel, and reporting.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runHouseholdMode(CommandLineArguments *  arguments);
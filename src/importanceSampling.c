@@ -0,0 +1,407 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <uxhw.h>
+#include "importanceSampling.h"
+#include "kernel.h"
+#include "specializedKernels.h"
+#include "statistics.h"
+
+
+#define kImportanceSamplingEliteFraction	(0.1)
+#define kImportanceSamplingMaxTilt		(300.0)
+
+enum
+{
+	kImportanceSamplingMaxNumberOfPilotStages	= 20,
+	kImportanceSamplingMinPilotSize			= 1000,
+	kImportanceSamplingMaxPilotSize			= 100000,
+	kImportanceSamplingTiltBisectionSteps		= 100,
+};
+
+/*
+ *	Inputs whose distributions are tilted. Their default distributions are Uniform(min, max) and a
+ *	shortfall is driven by low values of both.
+ */
+static const InputDistributionIndex	kTiltedInputs[] =
+					{
+						kInputDistributionIndexTotalAnnualContributionToAccount,
+						kInputDistributionIndexCompoundedAnnualInterestRate,
+					};
+static const double			kTiltedInputMin[] =
+					{
+						kDefaultInputDistributionConstantAnnualContributionMin,
+						kDefaultInputDistributionConstantAnnualInterestRateMin,
+					};
+static const double			kTiltedInputMax[] =
+					{
+						kDefaultInputDistributionConstantAnnualContributionMax,
+						kDefaultInputDistributionConstantAnnualInterestRateMax,
+					};
+
+enum
+{
+	kNumberOfTiltedInputs = sizeof(kTiltedInputs) / sizeof(kTiltedInputs[0]),
+};
+
+/*
+ *	A tilted input is sampled as `min + (max - min) * y`, where y in [0, 1] has the density
+ *	`s * exp(s * y) / (exp(s) - 1)`. The tilt s = 0 recovers the default uniform distribution.
+ */
+typedef struct
+{
+	bool	isTilted[kNumberOfTiltedInputs];
+	double	tilt[kNumberOfTiltedInputs];
+} ImportanceSamplingTilts;
+
+/**
+ *	@brief	Log of the normalizing constant `(exp(s) - 1) / s` of a tilted unit uniform.
+ *
+ *	@param	tilt	: The tilt s.
+ *	@return		: The log of the normalizing constant.
+ */
+static double
+logTiltNormalizer(double  tilt)
+{
+	if (tilt == 0.0)
+	{
+		return 0.0;
+	}
+
+	if (tilt > 0.0)
+	{
+		return tilt + log(-expm1(-tilt) / tilt);
+	}
+
+	return log(expm1(tilt) / tilt);
+}
+
+/**
+ *	@brief	Mean of a tilted unit uniform, `1 / (1 - exp(-s)) - 1 / s`.
+ *
+ *	@param	tilt	: The tilt s.
+ *	@return		: The mean.
+ */
+static double
+tiltedUnitUniformMean(double  tilt)
+{
+	if (fabs(tilt) < 1e-4)
+	{
+		return 0.5 + tilt / 12.0;
+	}
+
+	return 1.0 / (-expm1(-tilt)) - 1.0 / tilt;
+}
+
+/**
+ *	@brief	Find the tilt whose tilted unit uniform has the given mean, by bisection.
+ *
+ *	@param	mean	: The target mean, in (0, 1).
+ *	@return		: The tilt.
+ */
+static double
+solveTiltForMean(double  mean)
+{
+	double	low = -kImportanceSamplingMaxTilt;
+	double	high = kImportanceSamplingMaxTilt;
+
+	for (int i = 0; i < kImportanceSamplingTiltBisectionSteps; i++)
+	{
+		double	middle = 0.5 * (low + high);
+
+		if (tiltedUnitUniformMean(middle) < mean)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return 0.5 * (low + high);
+}
+
+/**
+ *	@brief	Set the input variables of one path, drawing tilted inputs from their tilted distributions.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@param	tilts		: The tilts.
+ *	@param	inputVariables	: The input variables to be set.
+ *	@return			: The log of the likelihood ratio of the path (nominal over tilted density).
+ */
+static double
+setTiltedInputVariables(
+	CommandLineArguments *		arguments,
+	ImportanceSamplingTilts *	tilts,
+	double *			inputVariables[kInputDistributionIndexMax])
+{
+	double	logLikelihoodRatio = 0.0;
+
+	setInputVariables(arguments, inputVariables);
+
+	for (size_t k = 0; k < kNumberOfTiltedInputs; k++)
+	{
+		double		tilt = tilts->tilt[k];
+		double		logNormalizer = logTiltNormalizer(tilt);
+		double		expm1Tilt = expm1(tilt);
+		double		min = kTiltedInputMin[k];
+		double		max = kTiltedInputMax[k];
+		double *	values = inputVariables[kTiltedInputs[k]];
+
+		if (!tilts->isTilted[k])
+		{
+			continue;
+		}
+
+		for (int i = 0; i < arguments->numberOfYearsToRetirement; i++)
+		{
+			double	u = UxHwDoubleUniformDist(0.0, 1.0);
+			double	y = (tilt == 0.0) ? u : log1p(u * expm1Tilt) / tilt;
+
+			values[i] = min + (max - min) * y;
+			logLikelihoodRatio += logNormalizer - tilt * y;
+		}
+	}
+
+	return logLikelihoodRatio;
+}
+
+/**
+ *	@brief	Choose the tilts with the cross-entropy method.
+ *
+ *	Each stage samples a pilot batch with the current tilts, sets the level to the larger of the
+ *	target and the elite-fraction quantile of the output, and moves each tilt so that the tilted
+ *	mean matches the likelihood-ratio-weighted mean of the input over the paths below that level.
+ *	The stages stop once the level reaches the target.
+ *
+ *	@param	arguments			: Pointer to command-line arguments struct.
+ *	@param	calculateOutputFunction		: The process kernel.
+ *	@param	inputVariables			: Scratch input variables.
+ *	@param	tilts				: The tilts, updated in place.
+ *	@return					: Number of kernel evaluations spent in the pilot stages.
+ */
+static size_t
+chooseTiltsWithCrossEntropy(
+	CommandLineArguments *		arguments,
+	CalculateOutputFunction		calculateOutputFunction,
+	double *			inputVariables[kInputDistributionIndexMax],
+	ImportanceSamplingTilts *	tilts)
+{
+	double		outputDistributions[kOutputDistributionIndexMax];
+	size_t		pilotSize = arguments->common.numberOfMonteCarloIterations / 10;
+	size_t		numberOfEvaluations = 0;
+	double *	pilotOutputs;
+	double *	sortedPilotOutputs;
+	double *	pilotLogLikelihoodRatios;
+	double *	pilotInputMeans;
+
+	if (pilotSize < kImportanceSamplingMinPilotSize)
+	{
+		pilotSize = kImportanceSamplingMinPilotSize;
+	}
+	if (pilotSize > kImportanceSamplingMaxPilotSize)
+	{
+		pilotSize = kImportanceSamplingMaxPilotSize;
+	}
+
+	pilotOutputs = (double *) checkedMalloc(pilotSize * sizeof(double), __FILE__, __LINE__);
+	sortedPilotOutputs = (double *) checkedMalloc(pilotSize * sizeof(double), __FILE__, __LINE__);
+	pilotLogLikelihoodRatios = (double *) checkedMalloc(pilotSize * sizeof(double), __FILE__, __LINE__);
+	pilotInputMeans = (double *) checkedMalloc(pilotSize * kNumberOfTiltedInputs * sizeof(double), __FILE__, __LINE__);
+
+	for (int stage = 0; stage < kImportanceSamplingMaxNumberOfPilotStages; stage++)
+	{
+		double	level;
+		double	maxLogLikelihoodRatio = -INFINITY;
+
+		for (size_t i = 0; i < pilotSize; i++)
+		{
+			pilotLogLikelihoodRatios[i] = setTiltedInputVariables(arguments, tilts, inputVariables);
+			calculateOutputFunction(arguments, arguments->numberOfYearsToRetirement, inputVariables, outputDistributions);
+			pilotOutputs[i] = outputDistributions[arguments->common.outputSelect];
+			sortedPilotOutputs[i] = pilotOutputs[i];
+
+			for (size_t k = 0; k < kNumberOfTiltedInputs; k++)
+			{
+				double *	values = inputVariables[kTiltedInputs[k]];
+				double		sum = 0.0;
+
+				for (int year = 0; year < arguments->numberOfYearsToRetirement; year++)
+				{
+					sum += (values[year] - kTiltedInputMin[k]) / (kTiltedInputMax[k] - kTiltedInputMin[k]);
+				}
+
+				pilotInputMeans[i * kNumberOfTiltedInputs + k] = sum / arguments->numberOfYearsToRetirement;
+			}
+
+			if (pilotLogLikelihoodRatios[i] > maxLogLikelihoodRatio)
+			{
+				maxLogLikelihoodRatio = pilotLogLikelihoodRatios[i];
+			}
+		}
+
+		numberOfEvaluations += pilotSize;
+
+		sortDoubleSamplesInParallel(sortedPilotOutputs, pilotSize, arguments->numberOfThreads);
+		level = sortedPilotOutputs[(size_t)(kImportanceSamplingEliteFraction * (pilotSize - 1))];
+		if (level < arguments->shortfallTarget)
+		{
+			level = arguments->shortfallTarget;
+		}
+
+		for (size_t k = 0; k < kNumberOfTiltedInputs; k++)
+		{
+			double	weightSum = 0.0;
+			double	weightedInputSum = 0.0;
+
+			if (!tilts->isTilted[k])
+			{
+				continue;
+			}
+
+			/*
+			 *	Weights are rescaled by the largest likelihood ratio, which cancels in the ratio.
+			 */
+			for (size_t i = 0; i < pilotSize; i++)
+			{
+				if (pilotOutputs[i] <= level)
+				{
+					double	weight = exp(pilotLogLikelihoodRatios[i] - maxLogLikelihoodRatio);
+
+					weightSum += weight;
+					weightedInputSum += weight * pilotInputMeans[i * kNumberOfTiltedInputs + k];
+				}
+			}
+
+			if (weightSum > 0.0)
+			{
+				tilts->tilt[k] = solveTiltForMean(weightedInputSum / weightSum);
+			}
+		}
+
+		if (level == arguments->shortfallTarget)
+		{
+			break;
+		}
+	}
+
+	free(pilotOutputs);
+	free(sortedPilotOutputs);
+	free(pilotLogLikelihoodRatios);
+	free(pilotInputMeans);
+
+	return numberOfEvaluations;
+}
+
+CommonConstantReturnType
+runImportanceSamplingMode(CommandLineArguments *  arguments)
+{
+	double *		inputVariables[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	ImportanceSamplingTilts	tilts = {0};
+	CalculateOutputFunction	calculateOutputFunction;
+	size_t			numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	size_t			numberOfPilotEvaluations;
+	double			sum = 0.0;
+	double			sumOfSquares = 0.0;
+	double			probability;
+	double			standardError;
+	double			relativeError;
+	clock_t			start;
+	double			cpuTimeUsedInSeconds;
+
+	for (size_t k = 0; k < kNumberOfTiltedInputs; k++)
+	{
+		tilts.isTilted[k] = !arguments->isInputVariableSet[kTiltedInputs[k]];
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		inputVariables[i] = (double *) checkedMalloc(arguments->numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, arguments->numberOfYearsToRetirement);
+
+	start = clock();
+
+	numberOfPilotEvaluations = chooseTiltsWithCrossEntropy(arguments, calculateOutputFunction, inputVariables, &tilts);
+
+	for (size_t i = 0; i < numberOfIterations; i++)
+	{
+		double	logLikelihoodRatio = setTiltedInputVariables(arguments, &tilts, inputVariables);
+
+		calculateOutputFunction(arguments, arguments->numberOfYearsToRetirement, inputVariables, outputDistributions);
+
+		if (outputDistributions[arguments->common.outputSelect] < arguments->shortfallTarget)
+		{
+			double	likelihoodRatio = exp(logLikelihoodRatio);
+
+			sum += likelihoodRatio;
+			sumOfSquares += likelihoodRatio * likelihoodRatio;
+		}
+	}
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	probability = sum / numberOfIterations;
+	standardError = sqrt(fmax(sumOfSquares / numberOfIterations - probability * probability, 0.0) / numberOfIterations);
+	relativeError = (probability > 0.0) ? (standardError / probability) : INFINITY;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%le %" PRIu64 "\n", probability, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		printf(
+			"Shortfall probability P(%s < %.2lf) is %le (standard error %le, relative error %lf).\n",
+			kOutputVariableNames[arguments->common.outputSelect],
+			arguments->shortfallTarget,
+			probability,
+			standardError,
+			relativeError);
+		printf(
+			"Kernel evaluations: %zu (pilot: %zu). Tilts: contribution %lf, interest rate %lf.\n",
+			numberOfIterations + numberOfPilotEvaluations,
+			numberOfPilotEvaluations,
+			tilts.tilt[0],
+			tilts.tilt[1]);
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		free(inputVariables[i]);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
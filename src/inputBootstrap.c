@@ -0,0 +1,469 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uxhw.h>
+#include "inputBootstrap.h"
+
+
+enum
+{
+	kInputBootstrapMaxNumberOfColumns = 64,
+	kInputBootstrapColumnIgnored = -1,
+	kInputBootstrapColumnWeight = -2,
+};
+
+static const char	kInputBootstrapWeightHeader[] = "weight";
+
+/**
+ *	@brief	Map the columns of the header of an input CSV file to the inputs they hold.
+ *
+ *	@param	line			: The header line, modified in place.
+ *	@param	columnInputs		: Per column, the input index, `kInputBootstrapColumnWeight`, or `kInputBootstrapColumnIgnored`.
+ *	@param	numberOfColumns		: Pointer to the number of columns, populated on success.
+ *	@param	isWeighted		: Pointer to whether the file has a weight column, populated on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if all inputs have a column, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseInputBootstrapHeader(
+	char *		line,
+	int		columnInputs[kInputBootstrapMaxNumberOfColumns],
+	size_t *	numberOfColumns,
+	bool *		isWeighted)
+{
+	bool	isInputFound[kInputDistributionIndexMax] = {false};
+	char *	saveptr = NULL;
+
+	*numberOfColumns = 0;
+	*isWeighted = false;
+
+	for (char * token = strtok_r(line, ",", &saveptr); token != NULL; token = strtok_r(NULL, ",", &saveptr))
+	{
+		size_t	length;
+
+		if (*numberOfColumns == kInputBootstrapMaxNumberOfColumns)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		token += strspn(token, " \t");
+		length = strcspn(token, " \t\r\n");
+		token[length] = '\0';
+		columnInputs[*numberOfColumns] = kInputBootstrapColumnIgnored;
+
+		for (int j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			if (strcmp(token, kInputCSVHeaders[j]) == 0)
+			{
+				columnInputs[*numberOfColumns] = j;
+				isInputFound[j] = true;
+			}
+		}
+
+		if (strcmp(token, kInputBootstrapWeightHeader) == 0)
+		{
+			columnInputs[*numberOfColumns] = kInputBootstrapColumnWeight;
+			*isWeighted = true;
+		}
+
+		(*numberOfColumns)++;
+	}
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		if (!isInputFound[j])
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief	Double the capacity of all columns of the bootstrap table.
+ *
+ *	@param	inputBootstrap	: Pointer to the bootstrap specification.
+ *	@param	weights		: Pointer to the weight column, grown if not `NULL`.
+ *	@param	capacity	: Pointer to the capacity of the columns, updated on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+growInputBootstrapTable(
+	InputBootstrap *	inputBootstrap,
+	double **		weights,
+	size_t *		capacity)
+{
+	size_t	newCapacity = (*capacity == 0) ? 1024 : 2 * (*capacity);
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		double *	column = realloc(inputBootstrap->columns[j], newCapacity * sizeof(double));
+
+		if (column == NULL)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+		inputBootstrap->columns[j] = column;
+	}
+
+	if (weights != NULL)
+	{
+		double *	column = realloc(*weights, newCapacity * sizeof(double));
+
+		if (column == NULL)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+		*weights = column;
+	}
+
+	*capacity = newCapacity;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief	Parse one row of an input CSV file into the bootstrap table.
+ *
+ *	@param	line			: The row to parse.
+ *	@param	columnInputs		: Per column, what the column holds, as from `parseInputBootstrapHeader()`.
+ *	@param	numberOfColumns		: Number of columns.
+ *	@param	inputBootstrap		: Pointer to the bootstrap specification.
+ *	@param	weights			: The weight column, or `NULL` if the file has none.
+ *	@param	row			: Index of the row to populate.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseInputBootstrapRow(
+	char *			line,
+	const int		columnInputs[kInputBootstrapMaxNumberOfColumns],
+	size_t			numberOfColumns,
+	InputBootstrap *	inputBootstrap,
+	double *		weights,
+	size_t			row)
+{
+	char *	cursor = line;
+	char *	end;
+
+	errno = 0;
+
+	for (size_t column = 0; column < numberOfColumns; column++)
+	{
+		double	value = strtod(cursor, &end);
+
+		if ((end == cursor) || ((column + 1 < numberOfColumns) ? (*end != ',') : (strspn(end, " \t\r\n") != strlen(end))))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (columnInputs[column] >= 0)
+		{
+			inputBootstrap->columns[columnInputs[column]][row] = value;
+		}
+		else if (columnInputs[column] == kInputBootstrapColumnWeight)
+		{
+			if (!isfinite(value) || (value < 0.0))
+			{
+				return kCommonConstantReturnTypeError;
+			}
+
+			weights[row] = value;
+		}
+
+		cursor = end + 1;
+	}
+
+	return (errno == 0) ? kCommonConstantReturnTypeSuccess : kCommonConstantReturnTypeError;
+}
+
+/**
+ *	@brief	Build the Walker alias table of the row weights, with Vose's method.
+ *
+ *	Row `k` keeps a fraction `aliasProbability[k]` of its slot of width `1 / numberOfRows`, and
+ *	gives the rest of the slot to row `aliasIndex[k]`, so that a draw takes one uniform variate, one
+ *	comparison, and no search.
+ *
+ *	@param	inputBootstrap	: Pointer to the bootstrap specification, with `numberOfRows` set.
+ *	@param	weights		: The row weights.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+buildInputBootstrapAliasTable(
+	InputBootstrap *	inputBootstrap,
+	const double *		weights)
+{
+	size_t		numberOfRows = inputBootstrap->numberOfRows;
+	double		sumOfWeights = 0.0;
+	uint32_t *	worklist;
+	size_t		numberOfSmall = 0;
+	size_t		numberOfLarge = 0;
+
+	for (size_t k = 0; k < numberOfRows; k++)
+	{
+		sumOfWeights += weights[k];
+	}
+
+	if (!(sumOfWeights > 0.0) || !isfinite(sumOfWeights))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	inputBootstrap->aliasProbability = (double *) checkedMalloc(numberOfRows * sizeof(double), __FILE__, __LINE__);
+	inputBootstrap->aliasIndex = (uint32_t *) checkedMalloc(numberOfRows * sizeof(uint32_t), __FILE__, __LINE__);
+
+	/*
+	 *	Rows with less than the average weight ("small") fill the front of the worklist, and the
+	 *	others ("large") its back.
+	 */
+	worklist = (uint32_t *) checkedMalloc(numberOfRows * sizeof(uint32_t), __FILE__, __LINE__);
+
+	for (size_t k = 0; k < numberOfRows; k++)
+	{
+		inputBootstrap->aliasProbability[k] = weights[k] * (double) numberOfRows / sumOfWeights;
+
+		if (inputBootstrap->aliasProbability[k] < 1.0)
+		{
+			worklist[numberOfSmall++] = (uint32_t) k;
+		}
+		else
+		{
+			worklist[numberOfRows - ++numberOfLarge] = (uint32_t) k;
+		}
+	}
+
+	while ((numberOfSmall > 0) && (numberOfLarge > 0))
+	{
+		uint32_t	small = worklist[--numberOfSmall];
+		uint32_t	large = worklist[numberOfRows - numberOfLarge--];
+
+		inputBootstrap->aliasIndex[small] = large;
+		inputBootstrap->aliasProbability[large] -= 1.0 - inputBootstrap->aliasProbability[small];
+
+		if (inputBootstrap->aliasProbability[large] < 1.0)
+		{
+			worklist[numberOfSmall++] = large;
+		}
+		else
+		{
+			worklist[numberOfRows - ++numberOfLarge] = large;
+		}
+	}
+
+	/*
+	 *	The rows left over keep their whole slot, up to rounding errors.
+	 */
+	while (numberOfSmall > 0)
+	{
+		uint32_t	k = worklist[--numberOfSmall];
+
+		inputBootstrap->aliasProbability[k] = 1.0;
+		inputBootstrap->aliasIndex[k] = k;
+	}
+
+	while (numberOfLarge > 0)
+	{
+		uint32_t	k = worklist[numberOfRows - numberOfLarge--];
+
+		inputBootstrap->aliasProbability[k] = 1.0;
+		inputBootstrap->aliasIndex[k] = k;
+	}
+
+	free(worklist);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+loadInputBootstrapTable(
+	const char *		path,
+	InputBootstrap *	inputBootstrap)
+{
+	char		line[kCommonConstantMaxCharsPerLine];
+	int		columnInputs[kInputBootstrapMaxNumberOfColumns];
+	size_t		numberOfColumns;
+	size_t		capacity = 0;
+	double *	weights = NULL;
+	FILE *		file = fopen(path, "r");
+
+	inputBootstrap->numberOfRows = 0;
+	inputBootstrap->isWeighted = false;
+	inputBootstrap->aliasProbability = NULL;
+	inputBootstrap->aliasIndex = NULL;
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		inputBootstrap->columns[j] = NULL;
+	}
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open input CSV file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fgets(line, sizeof(line), file) == NULL) ||
+		(parseInputBootstrapHeader(line, columnInputs, &numberOfColumns, &inputBootstrap->isWeighted) != kCommonConstantReturnTypeSuccess))
+	{
+		fprintf(stderr, "Error: The header of input CSV file \"%s\" must name the columns %s, %s, %s, and %s.\n",
+			path, kInputCSVHeaders[0], kInputCSVHeaders[1], kInputCSVHeaders[2], kInputCSVHeaders[3]);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		if (strspn(line, " \t\r\n") == strlen(line))
+		{
+			continue;
+		}
+
+		/*
+		 *	The alias table indexes rows with 32-bit integers.
+		 */
+		if ((inputBootstrap->numberOfRows == UINT32_MAX) ||
+			((inputBootstrap->numberOfRows == capacity) &&
+			(growInputBootstrapTable(inputBootstrap, inputBootstrap->isWeighted ? &weights : NULL, &capacity) != kCommonConstantReturnTypeSuccess)))
+		{
+			fprintf(stderr, "Error: Could not allocate memory for the bootstrap table.\n");
+			free(weights);
+			freeInputBootstrapTable(inputBootstrap);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (parseInputBootstrapRow(line, columnInputs, numberOfColumns, inputBootstrap, weights, inputBootstrap->numberOfRows) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: Malformed row %zu in input CSV file \"%s\".\n", inputBootstrap->numberOfRows + 1, path);
+			free(weights);
+			freeInputBootstrapTable(inputBootstrap);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		inputBootstrap->numberOfRows++;
+	}
+
+	fclose(file);
+
+	if (inputBootstrap->numberOfRows == 0)
+	{
+		fprintf(stderr, "Error: Input CSV file \"%s\" has no rows.\n", path);
+		freeInputBootstrapTable(inputBootstrap);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (inputBootstrap->isWeighted && (buildInputBootstrapAliasTable(inputBootstrap, weights) != kCommonConstantReturnTypeSuccess))
+	{
+		fprintf(stderr, "Error: The weights in input CSV file \"%s\" must not all be zero.\n", path);
+		free(weights);
+		freeInputBootstrapTable(inputBootstrap);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	free(weights);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+freeInputBootstrapTable(InputBootstrap *  inputBootstrap)
+{
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		free(inputBootstrap->columns[j]);
+		inputBootstrap->columns[j] = NULL;
+	}
+
+	free(inputBootstrap->aliasProbability);
+	free(inputBootstrap->aliasIndex);
+	inputBootstrap->aliasProbability = NULL;
+	inputBootstrap->aliasIndex = NULL;
+	inputBootstrap->numberOfRows = 0;
+
+	return;
+}
+
+size_t
+drawInputBootstrapRow(
+	const InputBootstrap *	inputBootstrap,
+	SamplingStream *	stream)
+{
+	double	u = (stream != NULL) ? samplingStreamUniform(stream, 0.0, 1.0) : UxHwDoubleUniformDist(0.0, 1.0);
+	double	slot = u * (double) inputBootstrap->numberOfRows;
+	size_t	row = (size_t) slot;
+
+	if (row >= inputBootstrap->numberOfRows)
+	{
+		row = inputBootstrap->numberOfRows - 1;
+	}
+
+	/*
+	 *	With weights, the fractional part of the slot picks the row or its alias.
+	 */
+	if (inputBootstrap->isWeighted && ((slot - (double) row) >= inputBootstrap->aliasProbability[row]))
+	{
+		row = inputBootstrap->aliasIndex[row];
+	}
+
+	return row;
+}
+
+void
+setBootstrappedInputVariables(
+	const InputBootstrap *	inputBootstrap,
+	int			numberOfYearsToRetirement,
+	SamplingStream *	stream,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	size_t	row = 0;
+
+	for (int i = 0; i < numberOfYearsToRetirement; i++)
+	{
+		if (((size_t) i % inputBootstrap->blockLength) == 0)
+		{
+			row = drawInputBootstrapRow(inputBootstrap, stream);
+		}
+		else
+		{
+			row = (row + 1 == inputBootstrap->numberOfRows) ? 0 : row + 1;
+		}
+
+		for (int j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			inputVariables[j][i] = inputBootstrap->columns[j][row];
+		}
+	}
+
+	return;
+}
@@ -0,0 +1,79 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Load the rows of an input CSV file into the bootstrap table of `inputBootstrap`.
+ *
+ *	The header must name the four input columns of the input CSV file, in any order, and may name
+ *	a `weight` column with non-negative row weights, in which case a Walker alias table is built so
+ *	that weighted rows are drawn in constant time. Other columns are ignored. The columns are stored
+ *	as a structure of arrays that is only read afterwards, so it can be shared between threads.
+ *
+ *	@param	path		: Path to the input CSV file.
+ *	@param	inputBootstrap	: Pointer to the bootstrap specification whose table to populate.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	loadInputBootstrapTable(
+					const char *		path,
+					InputBootstrap *	inputBootstrap);
+
+/**
+ *	@brief	Free the allocations of the bootstrap table of `inputBootstrap`.
+ *
+ *	@param	inputBootstrap	: Pointer to the bootstrap specification whose table to free.
+ */
+void	freeInputBootstrapTable(InputBootstrap *  inputBootstrap);
+
+/**
+ *	@brief	Draw the index of a row of the bootstrap table, uniformly or according to the row weights.
+ *
+ *	@param	inputBootstrap	: Pointer to the bootstrap specification.
+ *	@param	stream		: Sampling stream, or `NULL` to use UxHw calls (Monte Carlo mode only).
+ *	@return			: The row index.
+ */
+size_t	drawInputBootstrapRow(
+		const InputBootstrap *	inputBootstrap,
+		SamplingStream *	stream);
+
+/**
+ *	@brief	Set the input variables of one path by resampling rows of the bootstrap table.
+ *
+ *	Each row sets all four inputs of a year, which keeps the correlation between inputs. With a
+ *	block length of `l`, the years are split into blocks of `l` consecutive years, each of which
+ *	takes `l` consecutive rows (wrapping around the end of the table) from a drawn start row, which
+ *	keeps the serial structure of the rows within a block.
+ *
+ *	@param	inputBootstrap			: Pointer to the bootstrap specification.
+ *	@param	numberOfYearsToRetirement	: Number of years to set.
+ *	@param	stream				: Sampling stream, or `NULL` to use UxHw calls (Monte Carlo mode only).
+ *	@param	inputVariables			: The input variables to be set.
+ */
+void	setBootstrappedInputVariables(
+		const InputBootstrap *	inputBootstrap,
+		int			numberOfYearsToRetirement,
+		SamplingStream *	stream,
+		double *		inputVariables[kInputDistributionIndexMax]);
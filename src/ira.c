@@ -0,0 +1,349 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdlib.h>
+#include "ira.h"
+#include "kernel.h"
+#include "sampling.h"
+#include "utilities.h"
+
+
+_Static_assert((int) IRA_INPUT_TOTAL_ANNUAL_CONTRIBUTION == (int) kInputDistributionIndexTotalAnnualContributionToAccount, "ira_input must match InputDistributionIndex");
+_Static_assert((int) IRA_INPUT_COMPOUNDED_ANNUAL_INTEREST_RATE == (int) kInputDistributionIndexCompoundedAnnualInterestRate, "ira_input must match InputDistributionIndex");
+_Static_assert((int) IRA_INPUT_WITHDRAWAL_RATE == (int) kInputDistributionIndexWithdrawalRate, "ira_input must match InputDistributionIndex");
+_Static_assert((int) IRA_INPUT_ASSUMED_TAX_RATE_ON_INTEREST == (int) kInputDistributionIndexAssumedTaxRateOnInterest, "ira_input must match InputDistributionIndex");
+_Static_assert((int) IRA_OUTPUT_FUTURE_VALUE_TAXED == (int) kOutputDistributionIndexFutureValueTaxed, "ira_output must match OutputDistributionIndex");
+_Static_assert((int) IRA_OUTPUT_FUTURE_VALUE_TAXED_WITHDRAWAL == (int) kOutputDistributionIndexFutureValueTaxedWithdrawal, "ira_output must match OutputDistributionIndex");
+
+typedef struct
+{
+	ira_distribution	distribution;
+	double			parameter0;
+	double			parameter1;
+} IraInputDistribution;
+
+struct ira_context
+{
+	int			numberOfYearsToRetirement;
+	int			periodsPerYear;
+	uint64_t		seed;
+	IraInputDistribution	inputDistributions[IRA_INPUT_MAX];
+};
+
+static double
+evaluatePath(
+	const ira_context *	context,
+	ira_output		output,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	if (output == IRA_OUTPUT_FUTURE_VALUE_TAXED)
+	{
+		return calculateFutureValueTaxedCompounded(context->numberOfYearsToRetirement, context->periodsPerYear, inputVariables);
+	}
+
+	return calculateFutureValueTaxedWithdrawalCompounded(context->numberOfYearsToRetirement, context->periodsPerYear, inputVariables);
+}
+
+static double
+drawInput(const IraInputDistribution *  inputDistribution, SamplingStream *  stream)
+{
+	switch (inputDistribution->distribution)
+	{
+		case IRA_DISTRIBUTION_UNIFORM:
+			return samplingStreamUniform(stream, inputDistribution->parameter0, inputDistribution->parameter1);
+		case IRA_DISTRIBUTION_GAUSS:
+			return samplingStreamGauss(stream, inputDistribution->parameter0, inputDistribution->parameter1);
+		default:
+			return inputDistribution->parameter0;
+	}
+}
+
+/**
+ *	@brief	Draw and evaluate `numberOfPaths` paths, passing each output to `outputs` if not `NULL`,
+ *		and accumulating its statistics in `summary` if not `NULL`.
+ */
+static ira_status
+sampleAndEvaluate(
+	const ira_context *	context,
+	ira_output		output,
+	uint64_t		streamIndex,
+	size_t			numberOfPaths,
+	double *		outputs,
+	ira_summary *		summary)
+{
+	double *	inputVariables[kInputDistributionIndexMax];
+	double *	buffer;
+	size_t		numberOfYears = (size_t) context->numberOfYearsToRetirement;
+	SamplingStream	stream;
+	double		mean = 0.0;
+	double		sumOfSquaredDeviations = 0.0;
+	double		min = INFINITY;
+	double		max = -INFINITY;
+
+	if ((output < 0) || (output >= IRA_OUTPUT_MAX))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	buffer = (double *) malloc((numberOfYears > 0 ? numberOfYears : 1) * kInputDistributionIndexMax * sizeof(double));
+
+	if (buffer == NULL)
+	{
+		return IRA_STATUS_OUT_OF_MEMORY;
+	}
+
+	for (size_t k = 0; k < kInputDistributionIndexMax; k++)
+	{
+		inputVariables[k] = buffer + k * numberOfYears;
+	}
+
+	initSamplingStream(&stream, context->seed, streamIndex);
+
+	for (size_t p = 0; p < numberOfPaths; p++)
+	{
+		double	value;
+		double	deviation;
+
+		for (size_t i = 0; i < numberOfYears; i++)
+		{
+			for (size_t k = 0; k < kInputDistributionIndexMax; k++)
+			{
+				inputVariables[k][i] = drawInput(&context->inputDistributions[k], &stream);
+			}
+		}
+
+		value = evaluatePath(context, output, inputVariables);
+
+		if (outputs != NULL)
+		{
+			outputs[p] = value;
+		}
+
+		deviation = value - mean;
+		mean += deviation / (p + 1);
+		sumOfSquaredDeviations += deviation * (value - mean);
+		min = fmin(min, value);
+		max = fmax(max, value);
+	}
+
+	if (summary != NULL)
+	{
+		summary->number_of_paths = numberOfPaths;
+		summary->mean = mean;
+		summary->standard_deviation = (numberOfPaths > 1) ? sqrt(sumOfSquaredDeviations / (numberOfPaths - 1)) : 0.0;
+		summary->min = min;
+		summary->max = max;
+	}
+
+	free(buffer);
+
+	return IRA_STATUS_OK;
+}
+
+ira_context *
+ira_context_create(
+	int		number_of_years,
+	uint64_t	seed)
+{
+	ira_context *	context;
+
+	if (number_of_years < 0)
+	{
+		return NULL;
+	}
+
+	context = (ira_context *) malloc(sizeof(ira_context));
+
+	if (context == NULL)
+	{
+		return NULL;
+	}
+
+	context->numberOfYearsToRetirement = number_of_years;
+	context->periodsPerYear = kDemoFinanceIraDefaultPeriodsPerYear;
+	context->seed = seed;
+	context->inputDistributions[IRA_INPUT_TOTAL_ANNUAL_CONTRIBUTION] = (IraInputDistribution)
+	{
+		IRA_DISTRIBUTION_UNIFORM,
+		kDefaultInputDistributionConstantAnnualContributionMin,
+		kDefaultInputDistributionConstantAnnualContributionMax,
+	};
+	context->inputDistributions[IRA_INPUT_COMPOUNDED_ANNUAL_INTEREST_RATE] = (IraInputDistribution)
+	{
+		IRA_DISTRIBUTION_UNIFORM,
+		kDefaultInputDistributionConstantAnnualInterestRateMin,
+		kDefaultInputDistributionConstantAnnualInterestRateMax,
+	};
+	context->inputDistributions[IRA_INPUT_WITHDRAWAL_RATE] = (IraInputDistribution)
+	{
+		IRA_DISTRIBUTION_UNIFORM,
+		kDefaultInputDistributionConstantWithdrawalRateMin,
+		kDefaultInputDistributionConstantWithdrawalRateMax,
+	};
+	context->inputDistributions[IRA_INPUT_ASSUMED_TAX_RATE_ON_INTEREST] = (IraInputDistribution)
+	{
+		IRA_DISTRIBUTION_UNIFORM,
+		kDefaultInputDistributionConstantTaxRateInterestMin,
+		kDefaultInputDistributionConstantTaxRateInterestMax,
+	};
+
+	return context;
+}
+
+void
+ira_context_destroy(ira_context *  context)
+{
+	free(context);
+
+	return;
+}
+
+ira_status
+ira_set_periods_per_year(
+	ira_context *	context,
+	int		periods_per_year)
+{
+	if ((context == NULL) || (periods_per_year < 1))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	context->periodsPerYear = periods_per_year;
+
+	return IRA_STATUS_OK;
+}
+
+ira_status
+ira_set_input_distribution(
+	ira_context *		context,
+	ira_input		input,
+	ira_distribution	distribution,
+	double			parameter0,
+	double			parameter1)
+{
+	if ((context == NULL) || (input < 0) || (input >= IRA_INPUT_MAX) || !isfinite(parameter0))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	switch (distribution)
+	{
+		case IRA_DISTRIBUTION_CONSTANT:
+			break;
+		case IRA_DISTRIBUTION_UNIFORM:
+			if (!isfinite(parameter1) || (parameter1 < parameter0))
+			{
+				return IRA_STATUS_INVALID_ARGUMENT;
+			}
+			break;
+		case IRA_DISTRIBUTION_GAUSS:
+			if (!isfinite(parameter1) || (parameter1 < 0.0))
+			{
+				return IRA_STATUS_INVALID_ARGUMENT;
+			}
+			break;
+		default:
+			return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	context->inputDistributions[input] = (IraInputDistribution) { distribution, parameter0, parameter1 };
+
+	return IRA_STATUS_OK;
+}
+
+ira_status
+ira_evaluate_batch(
+	const ira_context *	context,
+	ira_output		output,
+	size_t			number_of_paths,
+	const double * const	inputs[IRA_INPUT_MAX],
+	double *		outputs)
+{
+	ira_input	unusedInput = (output == IRA_OUTPUT_FUTURE_VALUE_TAXED) ? IRA_INPUT_WITHDRAWAL_RATE : IRA_INPUT_ASSUMED_TAX_RATE_ON_INTEREST;
+	size_t		numberOfYears;
+
+	if ((context == NULL) || (output < 0) || (output >= IRA_OUTPUT_MAX) || (inputs == NULL) || ((outputs == NULL) && (number_of_paths > 0)))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	for (size_t k = 0; k < IRA_INPUT_MAX; k++)
+	{
+		if ((inputs[k] == NULL) && (k != (size_t) unusedInput))
+		{
+			return IRA_STATUS_INVALID_ARGUMENT;
+		}
+	}
+
+	numberOfYears = (size_t) context->numberOfYearsToRetirement;
+
+	for (size_t p = 0; p < number_of_paths; p++)
+	{
+		double *	inputVariables[kInputDistributionIndexMax];
+
+		/*
+		 *	The kernel only reads its inputs, so the caller's buffers are passed in place.
+		 */
+		for (size_t k = 0; k < kInputDistributionIndexMax; k++)
+		{
+			inputVariables[k] = (inputs[k] != NULL) ? (double *) inputs[k] + p * numberOfYears : NULL;
+		}
+
+		outputs[p] = evaluatePath(context, output, inputVariables);
+	}
+
+	return IRA_STATUS_OK;
+}
+
+ira_status
+ira_sample(
+	const ira_context *	context,
+	ira_output		output,
+	uint64_t		stream_index,
+	size_t			number_of_paths,
+	double *		outputs)
+{
+	if ((context == NULL) || ((outputs == NULL) && (number_of_paths > 0)))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	return sampleAndEvaluate(context, output, stream_index, number_of_paths, outputs, NULL);
+}
+
+ira_status
+ira_summarize(
+	const ira_context *	context,
+	ira_output		output,
+	uint64_t		stream_index,
+	size_t			number_of_paths,
+	ira_summary *		summary)
+{
+	if ((context == NULL) || (summary == NULL))
+	{
+		return IRA_STATUS_INVALID_ARGUMENT;
+	}
+
+	return sampleAndEvaluate(context, output, stream_index, number_of_paths, NULL, summary);
+}
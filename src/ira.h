@@ -0,0 +1,202 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *	The library is built with `-fvisibility=hidden`, so that only the functions below are exported.
+ */
+#if defined(__GNUC__)
+#define IRA_API	__attribute__((visibility("default")))
+#else
+#define IRA_API
+#endif
+
+
+/**
+ *	C API of the retirement account model, for in-process callers (`libira`).
+ *
+ *	The library performs no stdout or file I/O. A context holds the horizon, the compounding
+ *	periods, the seed, and the distribution of each input. Evaluation and sampling only read the
+ *	context, so several threads may use the same context concurrently. Sampling calls take a stream
+ *	index, and the same (seed, stream index) pair always yields the same samples.
+ */
+typedef struct ira_context	ira_context;
+
+typedef enum
+{
+	IRA_STATUS_OK			= 0,
+	IRA_STATUS_INVALID_ARGUMENT	= 1,
+	IRA_STATUS_OUT_OF_MEMORY	= 2,
+} ira_status;
+
+typedef enum
+{
+	IRA_INPUT_TOTAL_ANNUAL_CONTRIBUTION		= 0,
+	IRA_INPUT_COMPOUNDED_ANNUAL_INTEREST_RATE	= 1,
+	IRA_INPUT_WITHDRAWAL_RATE			= 2,
+	IRA_INPUT_ASSUMED_TAX_RATE_ON_INTEREST		= 3,
+	IRA_INPUT_MAX					= 4,
+} ira_input;
+
+typedef enum
+{
+	IRA_OUTPUT_FUTURE_VALUE_TAXED			= 0,
+	IRA_OUTPUT_FUTURE_VALUE_TAXED_WITHDRAWAL	= 1,
+	IRA_OUTPUT_MAX					= 2,
+} ira_output;
+
+typedef enum
+{
+	IRA_DISTRIBUTION_CONSTANT	= 0,
+	IRA_DISTRIBUTION_UNIFORM	= 1,
+	IRA_DISTRIBUTION_GAUSS		= 2,
+} ira_distribution;
+
+typedef struct
+{
+	uint64_t	number_of_paths;
+	double		mean;
+	double		standard_deviation;
+	double		min;
+	double		max;
+} ira_summary;
+
+/**
+ *	@brief	Create a context with the default input distributions of the application.
+ *
+ *	@param	number_of_years		: Number of years to retirement.
+ *	@param	seed			: Seed of the sampling streams.
+ *	@return				: The context, or `NULL` if out of memory or `number_of_years` is negative.
+ */
+IRA_API ira_context *	ira_context_create(
+			int		number_of_years,
+			uint64_t	seed);
+
+/**
+ *	@brief	Destroy a context.
+ *
+ *	@param	context		: The context, or `NULL`.
+ */
+IRA_API void	ira_context_destroy(ira_context *  context);
+
+/**
+ *	@brief	Set the number of compounding periods and contribution installments per year.
+ *
+ *	@param	context			: The context.
+ *	@param	periods_per_year	: Number of periods per year, at least 1 (the default).
+ *	@return				: `IRA_STATUS_OK`, or `IRA_STATUS_INVALID_ARGUMENT`.
+ */
+IRA_API ira_status	ira_set_periods_per_year(
+			ira_context *	context,
+			int		periods_per_year);
+
+/**
+ *	@brief	Set the distribution that each year of an input is drawn from, independently.
+ *
+ *	Rates are percentages, as on the command line.
+ *
+ *	@param	context		: The context.
+ *	@param	input		: The input.
+ *	@param	distribution	: The distribution family.
+ *	@param	parameter0	: The value of a constant, the lower bound of a uniform, or the mean of a Gauss distribution.
+ *	@param	parameter1	: Ignored for a constant, the upper bound of a uniform, or the standard deviation of a Gauss distribution.
+ *	@return			: `IRA_STATUS_OK`, or `IRA_STATUS_INVALID_ARGUMENT`.
+ */
+IRA_API ira_status	ira_set_input_distribution(
+			ira_context *		context,
+			ira_input		input,
+			ira_distribution	distribution,
+			double			parameter0,
+			double			parameter1);
+
+/**
+ *	@brief	Evaluate the model on caller-provided input paths, without copying them.
+ *
+ *	The inputs are in structure-of-arrays layout: `inputs[k]` holds input `k` for all paths, with
+ *	year `i` of path `p` at `inputs[k][p * number_of_years + i]`. The input that the output does
+ *	not depend on (the withdrawal rate for `IRA_OUTPUT_FUTURE_VALUE_TAXED`, the tax rate for
+ *	`IRA_OUTPUT_FUTURE_VALUE_TAXED_WITHDRAWAL`) may be `NULL`. The input distributions of the
+ *	context are not used.
+ *
+ *	@param	context			: The context.
+ *	@param	output			: The output to evaluate.
+ *	@param	number_of_paths		: Number of paths.
+ *	@param	inputs			: The input arrays.
+ *	@param	outputs			: Array of `number_of_paths` output values.
+ *	@return				: `IRA_STATUS_OK`, or `IRA_STATUS_INVALID_ARGUMENT`.
+ */
+IRA_API ira_status	ira_evaluate_batch(
+			const ira_context *	context,
+			ira_output		output,
+			size_t			number_of_paths,
+			const double * const	inputs[IRA_INPUT_MAX],
+			double *		outputs);
+
+/**
+ *	@brief	Draw input paths from the distributions of the context, and evaluate them.
+ *
+ *	@param	context			: The context.
+ *	@param	output			: The output to evaluate.
+ *	@param	stream_index		: Index of the sampling stream to draw from.
+ *	@param	number_of_paths		: Number of paths.
+ *	@param	outputs			: Array of `number_of_paths` output samples.
+ *	@return				: `IRA_STATUS_OK`, `IRA_STATUS_INVALID_ARGUMENT`, or `IRA_STATUS_OUT_OF_MEMORY`.
+ */
+IRA_API ira_status	ira_sample(
+			const ira_context *	context,
+			ira_output		output,
+			uint64_t		stream_index,
+			size_t			number_of_paths,
+			double *		outputs);
+
+/**
+ *	@brief	Like `ira_sample()`, but return summary statistics instead of the samples.
+ *
+ *	The samples are not stored, so memory use does not grow with `number_of_paths`.
+ *
+ *	@param	context			: The context.
+ *	@param	output			: The output to evaluate.
+ *	@param	stream_index		: Index of the sampling stream to draw from.
+ *	@param	number_of_paths		: Number of paths.
+ *	@param	summary			: Pointer to store the summary statistics.
+ *	@return				: `IRA_STATUS_OK`, `IRA_STATUS_INVALID_ARGUMENT`, or `IRA_STATUS_OUT_OF_MEMORY`.
+ */
+IRA_API ira_status	ira_summarize(
+			const ira_context *	context,
+			ira_output		output,
+			uint64_t		stream_index,
+			size_t			number_of_paths,
+			ira_summary *		summary);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,10 +20,91 @@
  *	SOFTWARE.
  */
 
+#include <math.h>
 #include "kernel.h"
 #include "utilities.h"
 
 
+/*
+ *	Number of years that the compounded kernels process per block. The per-year terms of a block
+ *	are independent of each other, so their loops vectorize; only the scan over the log growth
+ *	factors of a block is sequential.
+ */
+enum
+{
+	kCompoundedKernelBlockSize = 64,
+};
+
+/*
+ *	Future value of the output `outputIndex`, with the annual contributions paid in
+ *	`periodsPerYear` equal installments at the start of each period and the annual rates
+ *	compounded `periodsPerYear` times per year.
+ *
+ *	Rather than stepping through all periods, we work in log space: the growth of year i is
+ *	exp(L_i), with L_i = m*log1p(g_i/m), and the installments of year i grow to
+ *	(t_i/m)*(1 + g_i/m)*expm1(L_i)/(g_i/m) by the end of it. The future value is the sum of these
+ *	year-end values, each scaled by exp() of the suffix sum of the log growths of the later years.
+ *	The cost is therefore linear in the number of years, independent of `periodsPerYear`.
+ */
+static double
+calculateCompoundedFutureValue(
+	OutputDistributionIndex	outputIndex,
+	int			numberOfYearsToRetirement,
+	int			periodsPerYear,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	double *	totalAnnualContributionToAccount = inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount];
+	double *	compoundedAnnualInterestRate = inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate];
+	double *	assumedTaxRateOnInterest = inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest];
+	double *	withdrawalRate = inputVariables[kInputDistributionIndexWithdrawalRate];
+	bool		isTaxed = (outputIndex == kOutputDistributionIndexFutureValueTaxed);
+	double		m = periodsPerYear;
+	double		futureValue = 0.0;
+	double		laterYearsLogGrowth = 0.0;
+
+	for (int blockEnd = numberOfYearsToRetirement; blockEnd > 0; blockEnd -= kCompoundedKernelBlockSize)
+	{
+		int	blockStart = (blockEnd > kCompoundedKernelBlockSize) ? (blockEnd - kCompoundedKernelBlockSize) : 0;
+		int	blockSize = blockEnd - blockStart;
+		double	logGrowth[kCompoundedKernelBlockSize];
+		double	yearEndValue[kCompoundedKernelBlockSize];
+		double	suffixLogGrowth[kCompoundedKernelBlockSize];
+		double	blockValue = 0.0;
+
+		for (int k = 0; k < blockSize; k++)
+		{
+			int	i = blockStart + k;
+			double	annualRate = (compoundedAnnualInterestRate[i] / 100) * (isTaxed ? (1.0 - (assumedTaxRateOnInterest[i] / 100)) : 1.0);
+			double	annualContribution = totalAnnualContributionToAccount[i] * (isTaxed ? 1.0 : (1.0 - (withdrawalRate[i] / 100)));
+			double	periodRate = annualRate / m;
+
+			logGrowth[k] = m * log1p(periodRate);
+			yearEndValue[k] =
+				(annualContribution / m) *
+				((periodRate == 0.0) ? m : ((1.0 + periodRate) * expm1(logGrowth[k]) / periodRate));
+		}
+
+		/*
+		 *	Exclusive suffix scan of the log growths, offset by the log growth of the later blocks.
+		 */
+		for (int k = blockSize - 1; k >= 0; k--)
+		{
+			suffixLogGrowth[k] = laterYearsLogGrowth;
+			laterYearsLogGrowth += logGrowth[k];
+		}
+
+		for (int k = 0; k < blockSize; k++)
+		{
+			blockValue += yearEndValue[k] * exp(suffixLogGrowth[k]);
+		}
+
+		futureValue += blockValue;
+	}
+
+	return futureValue;
+}
+
+
 double
 calculateFutureValueTaxed(
 	int		numberOfYearsToRetirement,
@@ -72,6 +153,34 @@ calculateFutureValueTaxedWithdrawal(
 	return futureValue;
 }
 
+double
+calculateFutureValueTaxedCompounded(
+	int		numberOfYearsToRetirement,
+	int		periodsPerYear,
+	double *	inputVariables[kInputDistributionIndexMax])
+{
+	if (periodsPerYear == 1)
+	{
+		return calculateFutureValueTaxed(numberOfYearsToRetirement, inputVariables);
+	}
+
+	return calculateCompoundedFutureValue(kOutputDistributionIndexFutureValueTaxed, numberOfYearsToRetirement, periodsPerYear, inputVariables);
+}
+
+double
+calculateFutureValueTaxedWithdrawalCompounded(
+	int		numberOfYearsToRetirement,
+	int		periodsPerYear,
+	double *	inputVariables[kInputDistributionIndexMax])
+{
+	if (periodsPerYear == 1)
+	{
+		return calculateFutureValueTaxedWithdrawal(numberOfYearsToRetirement, inputVariables);
+	}
+
+	return calculateCompoundedFutureValue(kOutputDistributionIndexFutureValueTaxedWithdrawal, numberOfYearsToRetirement, periodsPerYear, inputVariables);
+}
+
 void
 calculateOutput(
 	CommandLineArguments *	arguments,
@@ -83,17 +192,60 @@ calculateOutput(
 
 	if (calculateAllOutputs || (arguments->common.outputSelect == kOutputDistributionIndexFutureValueTaxed))
 	{
-		outputDistributions[kOutputDistributionIndexFutureValueTaxed] = calculateFutureValueTaxed(
+		outputDistributions[kOutputDistributionIndexFutureValueTaxed] = calculateFutureValueTaxedCompounded(
 											numberOfYearsToRetirement,
+											arguments->periodsPerYear,
 											inputVariables);
 	}
 
 	if (calculateAllOutputs || (arguments->common.outputSelect == kOutputDistributionIndexFutureValueTaxedWithdrawal))
 	{
-		outputDistributions[kOutputDistributionIndexFutureValueTaxedWithdrawal] = calculateFutureValueTaxedWithdrawal(
+		outputDistributions[kOutputDistributionIndexFutureValueTaxedWithdrawal] = calculateFutureValueTaxedWithdrawalCompounded(
 												numberOfYearsToRetirement,
+												arguments->periodsPerYear,
 												inputVariables);
 	}
 
 	return;
 }
+
+size_t
+calculateDecumulationYear(
+	size_t		numberOfActivePaths,
+	double *	balances,
+	double *	withdrawals,
+	const double *	growthRates,
+	size_t *	pathIndices,
+	unsigned char *	isRuined,
+	int		year,
+	int *		yearsOfWithdrawals)
+{
+	size_t	numberOfPathsStillActive = 0;
+
+	/*
+	 *	Branch-free over the active paths, so that this loop vectorizes. The balances of ruined
+	 *	paths are discarded below.
+	 */
+	for (size_t j = 0; j < numberOfActivePaths; j++)
+	{
+		isRuined[j] = (balances[j] < withdrawals[j]);
+		balances[j] = (balances[j] - withdrawals[j]) * (1.0 + growthRates[j]);
+	}
+
+	for (size_t j = 0; j < numberOfActivePaths; j++)
+	{
+		if (isRuined[j])
+		{
+			yearsOfWithdrawals[pathIndices[j]] = year;
+
+			continue;
+		}
+
+		balances[numberOfPathsStillActive] = balances[j];
+		withdrawals[numberOfPathsStillActive] = withdrawals[j];
+		pathIndices[numberOfPathsStillActive] = pathIndices[j];
+		numberOfPathsStillActive++;
+	}
+
+	return numberOfPathsStillActive;
+}
@@ -23,6 +23,15 @@
 #include "utilities.h"
 
 
+/**
+ *	@brief	Signature shared by `calculateOutput()` and its specialized variants.
+ */
+typedef void	(*CalculateOutputFunction)(
+			CommandLineArguments *	arguments,
+			size_t			numberOfYearsToRetirement,
+			double *		inputVariables[kInputDistributionIndexMax],
+			double *		outputDistributions);
+
 /**
  *	@brief	Calculate taxed future value.
  *
@@ -45,6 +54,38 @@ double	calculateFutureValueTaxedWithdrawal(
 		int		numberOfYearsToRetirement,
 		double *	inputVariables[kInputDistributionIndexMax]);
 
+/**
+ *	@brief	Calculate taxed future value, compounding `periodsPerYear` times per year.
+ *
+ *	The annual contributions are paid in `periodsPerYear` equal installments at the start of
+ *	each period. With one period per year, this is `calculateFutureValueTaxed()`.
+ *
+ *	@param	numberOfYearsToRetirement	: Number of years to retirement.
+ *	@param	periodsPerYear			: Number of compounding periods per year.
+ *	@param	inputVariables			: The input variables.
+ *	@return					: Taxed future value.
+ */
+double	calculateFutureValueTaxedCompounded(
+		int		numberOfYearsToRetirement,
+		int		periodsPerYear,
+		double *	inputVariables[kInputDistributionIndexMax]);
+
+/**
+ *	@brief	Calculate taxed future value assuming a withdrawal rate, compounding `periodsPerYear` times per year.
+ *
+ *	The annual contributions are paid in `periodsPerYear` equal installments at the start of
+ *	each period. With one period per year, this is `calculateFutureValueTaxedWithdrawal()`.
+ *
+ *	@param	numberOfYearsToRetirement	: Number of years to retirement.
+ *	@param	periodsPerYear			: Number of compounding periods per year.
+ *	@param	inputVariables			: The input variables.
+ *	@return					: Tax free future value.
+ */
+double	calculateFutureValueTaxedWithdrawalCompounded(
+		int		numberOfYearsToRetirement,
+		int		periodsPerYear,
+		double *	inputVariables[kInputDistributionIndexMax]);
+
 /**
  *	@brief	Calculate output.
  *
@@ -58,3 +99,32 @@ void	calculateOutput(
 		size_t			numberOfYearsToRetirement,
 		double *		inputVariables[kInputDistributionIndexMax],
 		double *		outputDistributions);
+
+/**
+ *	@brief	Advance the active paths of a batch by one year of decumulation, and compact them.
+ *
+ *	Each active path withdraws its annual withdrawal at the start of the year, and the rest of its
+ *	balance grows at its growth rate for the year. A path whose balance cannot fund the withdrawal
+ *	is ruined: its number of years of withdrawals is recorded, and it is removed from the active
+ *	paths, which are moved to the front of the arrays in their order, so that later years only
+ *	process the paths that are still active.
+ *
+ *	@param	numberOfActivePaths	: Number of active paths, at the front of the arrays.
+ *	@param	balances		: Balances of the active paths.
+ *	@param	withdrawals		: Annual withdrawals of the active paths.
+ *	@param	growthRates		: Growth rates of the active paths for the year.
+ *	@param	pathIndices		: Indices in the batch of the active paths.
+ *	@param	isRuined		: Scratch array of at least `numberOfActivePaths` elements.
+ *	@param	year			: Number of years of withdrawals before this year.
+ *	@param	yearsOfWithdrawals	: Array, indexed by path index, to store the years of withdrawals of ruined paths.
+ *	@return				: Number of paths still active.
+ */
+size_t	calculateDecumulationYear(
+		size_t		numberOfActivePaths,
+		double *	balances,
+		double *	withdrawals,
+		const double *	growthRates,
+		size_t *	pathIndices,
+		unsigned char *	isRuined,
+		int		year,
+		int *		yearsOfWithdrawals);
@@ -23,13 +23,37 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "uxhw.h"
 #include "common.h"
 #include "utilities.h"
 #include "kernel.h"
+#include "household.h"
+#include "importanceSampling.h"
+#include "contributionSolver.h"
+#include "statistics.h"
+#include "streamingPipeline.h"
+#include "specializedKernels.h"
+#include "parallelMonteCarlo.h"
+#include "progressMetrics.h"
+#include "timeBudget.h"
+#include "asyncSampleWriter.h"
+#include "inputBootstrap.h"
+#include "moments.h"
+#include "checkpoint.h"
+#include "scenarioComparison.h"
+#include "controlVariate.h"
+#include "sampleArchive.h"
+#include "fusedKernel.h"
+#include "decumulation.h"
+#include "sobolIndices.h"
 
 
+/*
+ *	signaloid.yaml traces `outputDistributions` at the line of its declaration in `main()`. Update
+ *	its `LineNumber` when the declaration moves.
+ */
 int
 main(int argc, char *  argv[])
 {
@@ -47,21 +71,32 @@ main(int argc, char *  argv[])
 					"Withdrawal rate percentage",
 					"Assumed tax rate on interest percentage"
 				};
-	const char *		outputVariableNames[kOutputDistributionIndexMax] =
-				{
-					"futureValueTaxed",
-					"futureValueTaxFreeWithWithdrawalTax"
-				};
-
-	const char *		outputVariableDescriptions[kOutputDistributionIndexMax] =
-				{
-					"Future value, for yearly taxable payments (compounded annually)",
-					"Future value, for yearly tax-free payments and taxed withdrawal-events (compounded annually)"
-				};
+	char			outputVariableDescriptionStrings[kOutputDistributionIndexMax][kCommonConstantMaxCharsPerLine];
+	const char *		outputVariableDescriptions[kOutputDistributionIndexMax];
 
 	double *		monteCarloOutputSamples = NULL;
 	int			numberOfYearsToRetirement;
+	CalculateOutputFunction	calculateOutputFunction;
 	MeanAndVariance		monteCarloOutputMeanAndVariance = {0};
+	double			processStartTime = getMonotonicTimeInSeconds();
+	TimeBudget		timeBudget;
+	double			wallClockStartTime = 0.0;
+	AsyncSampleWriter	asyncSampleWriter;
+	double *		streamOutputChunk = NULL;
+	size_t			numberOfSamplesInStreamOutputChunk = 0;
+	double			streamOutputMean = 0.0;
+	double			streamOutputSumOfSquaredDeviations = 0.0;
+	ProgressMetrics		progressMetrics;
+	bool			isProgressMetricsEnabled;
+	ProgressCounter *	progressCounter = NULL;
+	size_t			maxNumberOfMonteCarloIterations;
+	CheckpointWriter	checkpointWriter;
+	SamplingStream		samplingStream;
+	SamplingStream *	inputSamplingStream = NULL;
+	size_t			firstMonteCarloIteration = 0;
+	FusedKernel		fusedKernel;
+	bool			isCorrelatedInputBatchEnabled;
+	double *		correlatedInputBatch[kInputDistributionIndexMax] = {NULL};
 
 	if (getCommandLineArguments(argc, argv, &arguments) != kCommonConstantReturnTypeSuccess)
 	{
@@ -69,16 +104,109 @@ main(int argc, char *  argv[])
 	}
 
 	/*
-	 *	Read input distributions from CSV if input from file is enabled.
+	 *	Unpack mode prints the samples of an archive and does not run the model.
 	 */
-	if (arguments.common.isInputFromFileEnabled)
+	if (arguments.isUnpackModeEnabled)
 	{
-		if (prepareCSVInputVariables(&arguments, inputVariables) != kCommonConstantReturnTypeSuccess)
+		return (runSampleArchiveUnpackMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Household mode evaluates several accounts per path and has its own reporting.
+	 */
+	if (arguments.isHouseholdModeEnabled)
+	{
+		return (runHouseholdMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Rare-event mode reports a likelihood-ratio-weighted probability instead of output samples.
+	 */
+	if (arguments.isImportanceSamplingEnabled)
+	{
+		return (runImportanceSamplingMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Goal-seek mode reports the required contribution instead of output samples.
+	 */
+	if (arguments.isContributionSolverEnabled)
+	{
+		return (runContributionSolverMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Streaming mode reads scenarios from stdin until end of file.
+	 */
+	if (arguments.isNdjsonModeEnabled)
+	{
+		return (runStreamingPipelineMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Moments mode reports the exact mean and variance of the outputs without sampling.
+	 */
+	if (arguments.isMomentsModeEnabled)
+	{
+		return (runMomentsMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Comparison mode reports the difference of two scenarios on the same sampled inputs.
+	 */
+	if (arguments.isScenarioComparisonEnabled)
+	{
+		return (runScenarioComparisonMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Control-variate mode reports the mean of the output corrected with the closed-form future value.
+	 */
+	if (arguments.isControlVariateEnabled)
+	{
+		return (runControlVariateMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Decumulation mode reports the probability and timing of ruin during retirement.
+	 */
+	if (arguments.isDecumulationEnabled)
+	{
+		return (runDecumulationMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Sensitivity mode reports the Sobol indices of the inputs instead of output samples.
+	 */
+	if (arguments.isSobolIndicesModeEnabled)
+	{
+		return (runSobolIndicesMode(&arguments) == kCommonConstantReturnTypeSuccess) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/*
+	 *	Progress metrics have one counter per thread that runs Monte Carlo iterations.
+	 */
+	isProgressMetricsEnabled = arguments.isMetricsFileSet || arguments.isProgressToStderrEnabled;
+
+	if (isProgressMetricsEnabled)
+	{
+		if (startProgressMetrics(
+			&progressMetrics,
+			&arguments,
+			arguments.isParallelMonteCarloEnabled ? (size_t) arguments.numberOfThreads : 1,
+			processStartTime) != kCommonConstantReturnTypeSuccess)
 		{
 			return EXIT_FAILURE;
 		}
+
+		progressCounter = &progressMetrics.counters[0];
 	}
 
+	/*
+	 *	The descriptions of the outputs state the compounding frequency of the arguments.
+	 */
+	prepareOutputVariableDescriptions(&arguments, outputVariableDescriptionStrings, outputVariableDescriptions);
+
 	/*
 	 *	Number of years to retirement is always from arguments.
 	 */
@@ -89,15 +217,73 @@ main(int argc, char *  argv[])
 		inputVariables[i] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
 	}
 
+	/*
+	 *	In Monte Carlo mode, correlated inputs are drawn from the sampling streams of NUMA-aware
+	 *	mode, `kParallelMonteCarloInputBatchSize` paths at a time, as with `-Q`, so that they take
+	 *	the same samples and the same batched path through the correlated sampler.
+	 */
+	isCorrelatedInputBatchEnabled = arguments.common.isMonteCarloMode && arguments.inputCorrelation.isEnabled && !arguments.common.isInputFromFileEnabled;
+
+	if (isCorrelatedInputBatchEnabled)
+	{
+		for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+		{
+			correlatedInputBatch[i] = (double *) checkedMalloc(kParallelMonteCarloInputBatchSize * numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+		}
+	}
+
+	/*
+	 *	Read input distributions from CSV if input from file is enabled. This must happen after
+	 *	`inputVariables` are allocated, as it populates them. In bootstrap mode, the rows of the
+	 *	CSV file are instead resampled for each path.
+	 */
+	if (arguments.common.isInputFromFileEnabled && !arguments.inputBootstrap.isEnabled)
+	{
+		if (prepareCSVInputVariables(&arguments, inputVariables) != kCommonConstantReturnTypeSuccess)
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	/*
+	 *	With streamed output, the samples go to "data.out" in chunks instead of to
+	 *	`monteCarloOutputSamples`, so only the two chunks of the writer are allocated.
+	 */
+	if (arguments.isStreamOutputEnabled)
+	{
+		if (openAsyncSampleWriter(&asyncSampleWriter, "data.out", arguments.streamOutputChunkSize) != kCommonConstantReturnTypeSuccess)
+		{
+			return EXIT_FAILURE;
+		}
+
+		streamOutputChunk = getAsyncSampleWriterChunk(&asyncSampleWriter);
+	}
 	/*
 	 *	Allocate for `monteCarloOutputSamples` if in Monte Carlo mode.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	else if (arguments.common.isMonteCarloMode)
 	{
-		monteCarloOutputSamples = (double *) checkedMalloc(
-			arguments.common.numberOfMonteCarloIterations * sizeof(double),
-			__FILE__,
-			__LINE__);
+		/*
+		 *	In NUMA-aware mode, the pages of the buffer are left untouched here, so that the
+		 *	worker threads place them on their own nodes.
+		 */
+		monteCarloOutputSamples = arguments.isParallelMonteCarloEnabled ?
+						allocateSampleBuffer(arguments.common.numberOfMonteCarloIterations, arguments.isHugePagesEnabled) :
+						(double *) checkedMalloc(
+							arguments.common.numberOfMonteCarloIterations * sizeof(double),
+							__FILE__,
+							__LINE__);
+	}
+
+	/*
+	 *	Select the process kernel once, outside of the loop. Common horizons use kernels that are
+	 *	specialized at compile time for the horizon and the selected output.
+	 */
+	calculateOutputFunction = selectCalculateOutputFunction(&arguments, numberOfYearsToRetirement);
+
+	if (arguments.isFusedKernelEnabled)
+	{
+		initFusedKernel(&fusedKernel, &arguments);
 	}
 
 	/*
@@ -108,45 +294,228 @@ main(int argc, char *  argv[])
 		start = clock();
 	}
 
+	if (isProgressMetricsEnabled)
+	{
+		setProgressPhase(&progressMetrics, kProgressPhaseSampling);
+	}
+
 	/*
-	 *	Execute process kernel in a loop. The size of loop is 1 unless in Monte Carlo mode.
+	 *	With a time budget, `-M` is the maximum number of iterations.
 	 */
-	for (size_t i = 0; i < arguments.common.numberOfMonteCarloIterations; ++i)
+	maxNumberOfMonteCarloIterations = arguments.common.numberOfMonteCarloIterations;
+
+	/*
+	 *	In NUMA-aware mode, pinned worker threads fill `monteCarloOutputSamples`.
+	 */
+	if (arguments.isParallelMonteCarloEnabled || arguments.isStreamOutputEnabled)
+	{
+		wallClockStartTime = getMonotonicTimeInSeconds();
+	}
+
+	if (arguments.isParallelMonteCarloEnabled)
+	{
+		if (calculateMonteCarloSamplesInParallel(&arguments, calculateOutputFunction, monteCarloOutputSamples, isProgressMetricsEnabled ? &progressMetrics : NULL) != kCommonConstantReturnTypeSuccess)
+		{
+			return EXIT_FAILURE;
+		}
+	}
+	else
 	{
 		/*
-		 *	Set inputs via UxHw calls if input from file is not enabled.
+		 *	With a time budget, the budget counts from the start of the process.
 		 */
-		if (!arguments.common.isInputFromFileEnabled)
+		if (arguments.isTimeBudgetSet)
 		{
-			setInputVariables(&arguments, inputVariables);
+			startTimeBudget(&timeBudget, processStartTime, arguments.timeBudgetInMilliseconds);
 		}
 
 		/*
-		 *	Execute process kernel.
+		 *	With checkpoints, inputs are drawn from the sampling streams of NUMA-aware mode, whose
+		 *	state at the start of a block of iterations follows from the seed and the block index.
+		 *	A resumed run continues at the block after the samples of the checkpoint.
 		 */
-		calculateOutput(&arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+		if (arguments.isCheckpointEnabled || isCorrelatedInputBatchEnabled)
+		{
+			inputSamplingStream = &samplingStream;
+		}
 
-		/*
-		 *	If in Monte Carlo mode, populate `monteCarloOutputSamples`.
-		 */
-		if (arguments.common.isMonteCarloMode)
+		if (arguments.isCheckpointEnabled)
 		{
-			monteCarloOutputSamples[i] = outputDistributions[arguments.common.outputSelect];
+
+			if (arguments.isResumeEnabled &&
+				(readCheckpoint(&arguments, monteCarloOutputSamples, &firstMonteCarloIteration) != kCommonConstantReturnTypeSuccess))
+			{
+				return EXIT_FAILURE;
+			}
+
+			if (startCheckpointWriter(&checkpointWriter, &arguments, monteCarloOutputSamples) != kCommonConstantReturnTypeSuccess)
+			{
+				return EXIT_FAILURE;
+			}
 		}
+
 		/*
-		 *	Else, if in benchmarking mode, populate `benchmarkOutput`.
+		 *	Execute process kernel in a loop. The size of loop is 1 unless in Monte Carlo mode.
 		 */
-		else if (arguments.common.isBenchmarkingMode)
+		for (size_t i = firstMonteCarloIteration; i < maxNumberOfMonteCarloIterations; ++i)
+		{
+			/*
+			 *	With a time budget, check the clock between chunks of iterations, and stop when
+			 *	the next chunk would not finish before the deadline.
+			 */
+			if (arguments.isTimeBudgetSet && (i > 0) && ((i % kTimeBudgetChunkSize) == 0) && !timeBudgetAllowsNextChunk(&timeBudget))
+			{
+				arguments.common.numberOfMonteCarloIterations = i;
+				break;
+			}
+
+			/*
+			 *	With checkpoints, hand the samples completed to the checkpoint writer between
+			 *	blocks of iterations. With checkpoints or correlated inputs, start the sampling
+			 *	stream of the next block.
+			 */
+			if ((inputSamplingStream != NULL) && ((i % kParallelMonteCarloBlockSize) == 0))
+			{
+				if (arguments.isCheckpointEnabled && (i > firstMonteCarloIteration))
+				{
+					requestCheckpoint(&checkpointWriter, i);
+				}
+
+				initSamplingStream(&samplingStream, arguments.seed, i / kParallelMonteCarloBlockSize);
+			}
+
+			/*
+			 *	In fused mode, draw the inputs and execute the process kernel in one pass. The
+			 *	input arrays are only filled for JSON output, which reports them.
+			 */
+			if (arguments.isFusedKernelEnabled)
+			{
+				runFusedKernel(&fusedKernel, inputSamplingStream, outputDistributions, arguments.common.isOutputJSONMode ? inputVariables : NULL);
+			}
+			else
+			{
+				/*
+				 *	Set inputs via UxHw calls (or the sampling stream, with checkpoints) if input
+				 *	from file is not enabled, or by resampling the rows of the input file in
+				 *	bootstrap mode. Correlated inputs are copied from the batch of the path.
+				 */
+				if (isCorrelatedInputBatchEnabled)
+				{
+					size_t	path = i % kParallelMonteCarloInputBatchSize;
+
+					if (path == 0)
+					{
+						size_t	batchLength = maxNumberOfMonteCarloIterations - i;
+
+						if (batchLength > kParallelMonteCarloInputBatchSize)
+						{
+							batchLength = kParallelMonteCarloInputBatchSize;
+						}
+
+						setInputVariablesBatchFromStream(&arguments, inputSamplingStream, batchLength, correlatedInputBatch);
+					}
+
+					for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+					{
+						memcpy(inputVariables[j], &correlatedInputBatch[j][path * numberOfYearsToRetirement], numberOfYearsToRetirement * sizeof(double));
+					}
+				}
+				else if (!arguments.common.isInputFromFileEnabled || arguments.inputBootstrap.isEnabled)
+				{
+					setInputVariablesFromStream(&arguments, inputSamplingStream, inputVariables);
+				}
+
+				/*
+				 *	Execute process kernel.
+				 */
+				calculateOutputFunction(&arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+			}
+
+			/*
+			 *	With streamed output, add the sample to the chunk and to the running mean and
+			 *	variance, and hand the chunk to the writer thread when it is full.
+			 */
+			if (arguments.isStreamOutputEnabled)
+			{
+				double	sample = outputDistributions[arguments.common.outputSelect];
+				double	delta = sample - streamOutputMean;
+
+				streamOutputMean += delta / (double)(i + 1);
+				streamOutputSumOfSquaredDeviations += delta * (sample - streamOutputMean);
+				streamOutputChunk[numberOfSamplesInStreamOutputChunk++] = sample;
+
+				if (numberOfSamplesInStreamOutputChunk == arguments.streamOutputChunkSize)
+				{
+					streamOutputChunk = submitAsyncSampleWriterChunk(&asyncSampleWriter, numberOfSamplesInStreamOutputChunk);
+					numberOfSamplesInStreamOutputChunk = 0;
+				}
+
+				if (progressCounter != NULL)
+				{
+					recordProgressSample(progressCounter, sample);
+				}
+			}
+			/*
+			 *	If in Monte Carlo mode, populate `monteCarloOutputSamples`.
+			 */
+			else if (arguments.common.isMonteCarloMode)
+			{
+				monteCarloOutputSamples[i] = outputDistributions[arguments.common.outputSelect];
+
+				if (progressCounter != NULL)
+				{
+					recordProgressSample(progressCounter, monteCarloOutputSamples[i]);
+				}
+			}
+			/*
+			 *	Else, if in benchmarking mode, populate `benchmarkOutput`.
+			 */
+			else if (arguments.common.isBenchmarkingMode)
+			{
+				benchmarkOutput = outputDistributions[arguments.common.outputSelect];
+			}
+		}
+
+		if (arguments.isCheckpointEnabled)
 		{
-			benchmarkOutput = outputDistributions[arguments.common.outputSelect];
+			stopCheckpointWriter(&checkpointWriter);
 		}
 	}
 
+	if (isProgressMetricsEnabled)
+	{
+		if (!arguments.isParallelMonteCarloEnabled)
+		{
+			publishProgressCounter(progressCounter);
+		}
+
+		setProgressPhase(&progressMetrics, kProgressPhasePostProcessing);
+	}
+
+	/*
+	 *	With streamed output, write the last, partial chunk, and wait for the writer thread, so
+	 *	that the time includes writing the samples. The mean and variance are already known.
+	 */
+	if (arguments.isStreamOutputEnabled)
+	{
+		if (numberOfSamplesInStreamOutputChunk > 0)
+		{
+			submitAsyncSampleWriterChunk(&asyncSampleWriter, numberOfSamplesInStreamOutputChunk);
+		}
+
+		flushAsyncSampleWriter(&asyncSampleWriter);
+
+		monteCarloOutputMeanAndVariance.mean = streamOutputMean;
+		monteCarloOutputMeanAndVariance.variance = (arguments.common.numberOfMonteCarloIterations > 1) ?
+								streamOutputSumOfSquaredDeviations / (double)(arguments.common.numberOfMonteCarloIterations - 1) :
+								0.0;
+		benchmarkOutput = monteCarloOutputMeanAndVariance.mean;
+	}
 	/*
 	 *	If not doing Laplace version, then approximate the cost of the third phase of
 	 *	Monte Carlo (post-processing), by calculating the mean and variance.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	else if (arguments.common.isMonteCarloMode)
 	{
 		monteCarloOutputMeanAndVariance = calculateMeanAndVarianceOfDoubleSamples(
 								monteCarloOutputSamples,
@@ -161,14 +530,79 @@ main(int argc, char *  argv[])
 	{
 		end = clock();
 		cpuTimeUsedInSeconds = ((double)(end - start)) / CLOCKS_PER_SEC;
+
+		/*
+		 *	In NUMA-aware mode, use wall-clock time, as CPU time adds up over the threads. With
+		 *	streamed output, use wall-clock time too, as CPU time includes the writer thread.
+		 */
+		if (arguments.isParallelMonteCarloEnabled || arguments.isStreamOutputEnabled)
+		{
+			cpuTimeUsedInSeconds = getMonotonicTimeInSeconds() - wallClockStartTime;
+		}
+	}
+
+	if (isProgressMetricsEnabled)
+	{
+		setProgressPhase(&progressMetrics, kProgressPhaseOutput);
 	}
 
+	/*
+	 *	If in benchmarking mode with a reference, print timing result in a special format:
+	 *		(1) Benchmark output
+	 *		(2) Wasserstein-1 distance of the output samples to the reference
+	 *		(3) Time in microseconds
+	 *	The distance is computed on sorted copies, so `monteCarloOutputSamples` keeps its order.
+	 */
+	if (arguments.isReferenceSet)
+	{
+		double *	referenceSamples;
+		size_t		numberOfReferenceSamples;
+		double *	sortedOutputSamples;
+		double		wassersteinDistance;
+
+		if (readBinaryDoubleSamples(arguments.referenceFilePath, &referenceSamples, &numberOfReferenceSamples) != kCommonConstantReturnTypeSuccess)
+		{
+			return EXIT_FAILURE;
+		}
+
+		sortedOutputSamples = (double *) checkedMalloc(arguments.common.numberOfMonteCarloIterations * sizeof(double), __FILE__, __LINE__);
+		memcpy(sortedOutputSamples, monteCarloOutputSamples, arguments.common.numberOfMonteCarloIterations * sizeof(double));
+
+		sortDoubleSamplesInParallel(sortedOutputSamples, arguments.common.numberOfMonteCarloIterations, arguments.numberOfThreads);
+		sortDoubleSamplesInParallel(referenceSamples, numberOfReferenceSamples, arguments.numberOfThreads);
+		wassersteinDistance = calculateWassersteinDistance(
+					sortedOutputSamples,
+					arguments.common.numberOfMonteCarloIterations,
+					referenceSamples,
+					numberOfReferenceSamples);
+
+		printf("%lf %le %" PRIu64 "\n", benchmarkOutput, wassersteinDistance, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+
+		free(sortedOutputSamples);
+		free(referenceSamples);
+	}
+	/*
+	 *	If in benchmarking mode with a time budget, print timing result in a special format:
+	 *		(1) Benchmark output
+	 *		(2) Standard error of the benchmark output
+	 *		(3) Number of iterations completed
+	 *		(4) Time in microseconds
+	 */
+	else if (arguments.common.isBenchmarkingMode && arguments.isTimeBudgetSet)
+	{
+		printf(
+			"%lf %le %zu %" PRIu64 "\n",
+			benchmarkOutput,
+			sqrt(monteCarloOutputMeanAndVariance.variance / arguments.common.numberOfMonteCarloIterations),
+			arguments.common.numberOfMonteCarloIterations,
+			(uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
 	/*
 	 *	If in benchmarking mode, print timing result in a special format:
 	 *		(1) Benchmark output (for calculating Wasserstein distance to reference)
 	 *		(2) Time in microseconds
 	 */
-	if (arguments.common.isBenchmarkingMode)
+	else if (arguments.common.isBenchmarkingMode)
 	{
 		printf("%lf %" PRIu64 "\n", benchmarkOutput, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
 	}
@@ -190,6 +624,19 @@ main(int argc, char *  argv[])
 				outputVariableDescriptions,
 				monteCarloOutputSamples);
 		}
+		/*
+		 *	With streamed output, the samples are only in "data.out", so print their summary.
+		 */
+		else if (arguments.isStreamOutputEnabled)
+		{
+			printf(
+				"%s %s: mean $%.2lf, standard deviation $%.2lf, over %zu samples streamed to data.out.\n",
+				outputVariableDescriptions[arguments.common.outputSelect],
+				kOutputVariableNames[arguments.common.outputSelect],
+				monteCarloOutputMeanAndVariance.mean,
+				sqrt(monteCarloOutputMeanAndVariance.variance),
+				arguments.common.numberOfMonteCarloIterations);
+		}
 		/*
 		 *	Print human-consumable output if not in JSON output mode.
 		 */
@@ -198,11 +645,24 @@ main(int argc, char *  argv[])
 			printHumanConsumableOutput(
 				&arguments,
 				outputDistributions,
-				outputVariableNames,
+				kOutputVariableNames,
 				outputVariableDescriptions,
 				monteCarloOutputSamples);
 		}
 
+		/*
+		 *	Print the iterations completed within the time budget, and the resulting standard error.
+		 */
+		if (arguments.isTimeBudgetSet && !arguments.common.isOutputJSONMode)
+		{
+			printf(
+				"\nTime budget of %.1lf ms: completed %zu of at most %zu iterations, standard error of the mean %le.\n",
+				arguments.timeBudgetInMilliseconds,
+				arguments.common.numberOfMonteCarloIterations,
+				maxNumberOfMonteCarloIterations,
+				sqrt(monteCarloOutputMeanAndVariance.variance / arguments.common.numberOfMonteCarloIterations));
+		}
+
 		/*
 		 *	Print timing if timing is enabled.
 		 */
@@ -212,15 +672,38 @@ main(int argc, char *  argv[])
 		}
 	}
 
+	/*
+	 *	With streamed output, the samples are already in "data.out", so only the time is left to write.
+	 */
+	if (arguments.isStreamOutputEnabled)
+	{
+		if (closeAsyncSampleWriter(&asyncSampleWriter, (uint64_t)(cpuTimeUsedInSeconds * 1000000)) != kCommonConstantReturnTypeSuccess)
+		{
+			return EXIT_FAILURE;
+		}
+	}
 	/*
 	 *	Save Monte Carlo data to "data.out" if in Monte Carlo mode.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	else if (arguments.common.isMonteCarloMode)
 	{
 		saveMonteCarloDoubleDataToDataDotOutFile(
 			monteCarloOutputSamples,
 			(uint64_t)(cpuTimeUsedInSeconds * 1000000),
 			arguments.common.numberOfMonteCarloIterations);
+
+		if (arguments.isSampleArchiveEnabled)
+		{
+			if (writeSampleArchive(
+				arguments.sampleArchiveFilePath,
+				monteCarloOutputSamples,
+				arguments.common.numberOfMonteCarloIterations,
+				arguments.sampleArchiveQuantum,
+				arguments.numberOfThreads) != kCommonConstantReturnTypeSuccess)
+			{
+				return EXIT_FAILURE;
+			}
+		}
 	}
 	/*
 	 *	Save outputs to file if not in Monte Carlo mode and write to file is enabled.
@@ -232,7 +715,7 @@ main(int argc, char *  argv[])
 			if (writeOutputDoubleDistributionsToCSV(
 				arguments.common.outputFilePath,
 				outputDistributions,
-				outputVariableNames,
+				kOutputVariableNames,
 				kOutputDistributionIndexMax))
 			{
 				fprintf(stderr, "Error: Could not write to output CSV file \"%s\".\n", arguments.common.outputFilePath);
@@ -241,6 +724,14 @@ main(int argc, char *  argv[])
 		}
 	}
 
+	/*
+	 *	Report the final metrics, once all outputs are written.
+	 */
+	if (isProgressMetricsEnabled)
+	{
+		stopProgressMetrics(&progressMetrics);
+	}
+
 	/*
 	 *	Free allocations.
 	 */
@@ -252,6 +743,12 @@ main(int argc, char *  argv[])
 	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
 	{
 		free(inputVariables[i]);
+		free(correlatedInputBatch[i]);
+	}
+
+	if (arguments.inputBootstrap.isEnabled)
+	{
+		freeInputBootstrapTable(&arguments.inputBootstrap);
 	}
 
 	return EXIT_SUCCESS;
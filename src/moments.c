@@ -0,0 +1,197 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "moments.h"
+
+
+/**
+ *	@brief	Return the mean and variance of an input: a constant, if set from the command line, or
+ *		else its default uniform distribution.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@param	input		: The input.
+ *	@return			: The mean and variance of the input.
+ */
+static MeanAndVariance
+getInputMoments(
+	CommandLineArguments *	arguments,
+	InputDistributionIndex	input)
+{
+	MeanAndVariance	moments = {0};
+
+	if (arguments->isInputVariableSet[input])
+	{
+		sscanf(arguments->inputVariablesUxStrings[input], "%lf", &moments.mean);
+
+		return moments;
+	}
+
+	moments.mean = (kDefaultInputDistributionMin[input] + kDefaultInputDistributionMax[input]) / 2.0;
+	moments.variance = (kDefaultInputDistributionMax[input] - kDefaultInputDistributionMin[input]) * (kDefaultInputDistributionMax[input] - kDefaultInputDistributionMin[input]) / 12.0;
+
+	return moments;
+}
+
+/**
+ *	@brief	Return the mean and variance of `offset + scale * x`.
+ */
+static MeanAndVariance
+affineMoments(
+	MeanAndVariance	x,
+	double		offset,
+	double		scale)
+{
+	MeanAndVariance	moments;
+
+	moments.mean = offset + scale * x.mean;
+	moments.variance = scale * scale * x.variance;
+
+	return moments;
+}
+
+/**
+ *	@brief	Return the mean and variance of `x + y`, for independent `x` and `y`.
+ */
+static MeanAndVariance
+sumOfIndependentMoments(
+	MeanAndVariance	x,
+	MeanAndVariance	y)
+{
+	MeanAndVariance	moments;
+
+	moments.mean = x.mean + y.mean;
+	moments.variance = x.variance + y.variance;
+
+	return moments;
+}
+
+/**
+ *	@brief	Return the mean and variance of `x * y`, for independent `x` and `y`.
+ *
+ *	The variance is written as a sum of non-negative terms, which avoids the cancellation of
+ *	`E[x^2] E[y^2] - E[x]^2 E[y]^2`.
+ */
+static MeanAndVariance
+productOfIndependentMoments(
+	MeanAndVariance	x,
+	MeanAndVariance	y)
+{
+	MeanAndVariance	moments;
+
+	moments.mean = x.mean * y.mean;
+	moments.variance = x.variance * y.variance + x.variance * y.mean * y.mean + y.variance * x.mean * x.mean;
+
+	return moments;
+}
+
+MeanAndVariance
+calculateOutputMoments(
+	CommandLineArguments *	arguments,
+	OutputDistributionIndex	outputSelect)
+{
+	MeanAndVariance	contribution = getInputMoments(arguments, kInputDistributionIndexTotalAnnualContributionToAccount);
+	MeanAndVariance	interestRate = affineMoments(getInputMoments(arguments, kInputDistributionIndexCompoundedAnnualInterestRate), 0.0, 0.01);
+	MeanAndVariance	contributionTerm;
+	MeanAndVariance	growthFactor;
+	MeanAndVariance	futureValue = {0};
+
+	/*
+	 *	The contribution term and growth factor of a year, as in the kernels of `kernel.c`:
+	 *		taxed:			a = t,			g = 1 + (c / 100) (1 - r / 100),
+	 *		taxed withdrawal:	a = t (1 - w / 100),	g = 1 + c / 100.
+	 *	All years have the same input distributions.
+	 */
+	if (outputSelect == kOutputDistributionIndexFutureValueTaxed)
+	{
+		MeanAndVariance	afterTaxFraction = affineMoments(getInputMoments(arguments, kInputDistributionIndexAssumedTaxRateOnInterest), 1.0, -0.01);
+
+		contributionTerm = contribution;
+		growthFactor = affineMoments(productOfIndependentMoments(interestRate, afterTaxFraction), 1.0, 1.0);
+	}
+	else
+	{
+		MeanAndVariance	afterWithdrawalFraction = affineMoments(getInputMoments(arguments, kInputDistributionIndexWithdrawalRate), 1.0, -0.01);
+
+		contributionTerm = productOfIndependentMoments(contribution, afterWithdrawalFraction);
+		growthFactor = affineMoments(interestRate, 1.0, 1.0);
+	}
+
+	/*
+	 *	The inputs of a year are independent of the future value accumulated before it.
+	 */
+	for (int i = 0; i < arguments->numberOfYearsToRetirement; i++)
+	{
+		futureValue = productOfIndependentMoments(sumOfIndependentMoments(futureValue, contributionTerm), growthFactor);
+	}
+
+	return futureValue;
+}
+
+CommonConstantReturnType
+runMomentsMode(CommandLineArguments *  arguments)
+{
+	MeanAndVariance		outputMoments[kOutputDistributionIndexMax];
+	OutputDistributionIndex	outputSelectLowerBound = (arguments->common.outputSelect == kOutputDistributionIndexMax) ? 0 : arguments->common.outputSelect;
+	OutputDistributionIndex	outputSelectUpperBound = (arguments->common.outputSelect == kOutputDistributionIndexMax) ? kOutputDistributionIndexMax : arguments->common.outputSelect + 1;
+	double			cpuTimeUsedInSeconds;
+	clock_t			start;
+
+	start = clock();
+
+	for (OutputDistributionIndex outputSelect = outputSelectLowerBound; outputSelect < outputSelectUpperBound; outputSelect++)
+	{
+		outputMoments[outputSelect] = calculateOutputMoments(arguments, outputSelect);
+	}
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf(
+			"%lf %lf %" PRIu64 "\n",
+			outputMoments[outputSelectLowerBound].mean,
+			sqrt(outputMoments[outputSelectLowerBound].variance),
+			(uint64_t)(cpuTimeUsedInSeconds * 1000000));
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	for (OutputDistributionIndex outputSelect = outputSelectLowerBound; outputSelect < outputSelectUpperBound; outputSelect++)
+	{
+		printf(
+			"%s: mean $%.2lf, standard deviation $%.2lf (exact, from the input moments).\n",
+			kOutputVariableNames[outputSelect],
+			outputMoments[outputSelect].mean,
+			sqrt(outputMoments[outputSelect].variance));
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
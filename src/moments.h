@@ -0,0 +1,51 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Calculate the exact mean and variance of an output from the moments of the inputs.
+ *
+ *	With independent inputs, the future value after year `i`, `F' = (F + a) g`, is a sum and a
+ *	product of independent terms, so its mean and variance follow from those of `F`, of the
+ *	contribution term `a`, and of the growth factor `g` of the year. Inputs are either constant
+ *	(set from the command line) or have their default uniform distributions.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@param	outputSelect	: The output whose moments to calculate.
+ *	@return			: The mean and variance of the output.
+ */
+MeanAndVariance	calculateOutputMoments(
+			CommandLineArguments *	arguments,
+			OutputDistributionIndex	outputSelect);
+
+/**
+ *	@brief	Run the moments mode: report the exact mean and standard deviation of the selected
+ *		outputs, without sampling.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runMomentsMode(CommandLineArguments *  arguments);
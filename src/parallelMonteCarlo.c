@@ -0,0 +1,471 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallelMonteCarlo.h"
+#include "fusedKernel.h"
+#include "sampling.h"
+
+
+enum
+{
+	kParallelMonteCarloMaxNumberOfNodes	= 64,
+	kParallelMonteCarloMaxCharsPerCpuList	= 4096,
+	kParallelMonteCarloHugePageSize		= 2 * 1024 * 1024,
+};
+
+typedef struct
+{
+	CommandLineArguments *	arguments;
+	CalculateOutputFunction	calculateOutputFunction;
+	double *		samples;
+	ProgressCounter *	progressCounter;
+	size_t			firstIteration;
+	size_t			endIteration;
+	int			cpu;
+} ParallelMonteCarloWorker;
+
+CommonConstantReturnType
+parseCpuList(
+	const char *	string,
+	int *		cpus,
+	size_t		maxNumberOfCpus,
+	size_t *	numberOfCpus)
+{
+	const char *	cursor = string;
+
+	*numberOfCpus = 0;
+
+	while (true)
+	{
+		char *	end;
+		long	first;
+		long	last;
+
+		if (!isdigit((unsigned char) *cursor))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		errno = 0;
+		first = strtol(cursor, &end, 10);
+		last = first;
+
+		if (*end == '-')
+		{
+			cursor = end + 1;
+
+			if (!isdigit((unsigned char) *cursor))
+			{
+				return kCommonConstantReturnTypeError;
+			}
+
+			last = strtol(cursor, &end, 10);
+		}
+
+		if ((errno != 0) || (last < first) || (last > INT_MAX))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		for (long cpu = first; cpu <= last; cpu++)
+		{
+			if (*numberOfCpus == maxNumberOfCpus)
+			{
+				return kCommonConstantReturnTypeError;
+			}
+
+			cpus[(*numberOfCpus)++] = (int) cpu;
+		}
+
+		/*
+		 *	Lists read from sysfs end with a newline.
+		 */
+		if ((*end == '\0') || (*end == '\n'))
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+
+		if (*end != ',')
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = end + 1;
+	}
+}
+
+double *
+allocateSampleBuffer(
+	size_t	numberOfSamples,
+	bool	useHugePages)
+{
+	void *	buffer = NULL;
+	size_t	sizeInBytes = numberOfSamples * sizeof(double);
+
+	if (!useHugePages)
+	{
+		return (double *) checkedMalloc(sizeInBytes, __FILE__, __LINE__);
+	}
+
+	/*
+	 *	Round up to whole huge pages, so that the tail of the buffer can be a huge page too.
+	 */
+	sizeInBytes = (sizeInBytes + kParallelMonteCarloHugePageSize - 1) / kParallelMonteCarloHugePageSize * kParallelMonteCarloHugePageSize;
+
+	if (posix_memalign(&buffer, kParallelMonteCarloHugePageSize, sizeInBytes) != 0)
+	{
+		fprintf(stderr, "Error: Could not allocate %zu bytes for samples.\n", sizeInBytes);
+		exit(EXIT_FAILURE);
+	}
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if (madvise(buffer, sizeInBytes, MADV_HUGEPAGE) != 0)
+	{
+		fprintf(stderr, "Warning: Transparent huge pages are not available. Continuing with regular pages.\n");
+	}
+#else
+	fprintf(stderr, "Warning: Transparent huge pages are not supported on this platform. Continuing with regular pages.\n");
+#endif
+
+	return (double *) buffer;
+}
+
+/**
+ *	@brief	Get the CPUs that the process may run on, in ascending order.
+ */
+static size_t
+getAllowedCpus(int *  cpus, size_t  maxNumberOfCpus)
+{
+	size_t		numberOfCpus = 0;
+#if defined(__linux__)
+	cpu_set_t	allowedCpus;
+
+	if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) == 0)
+	{
+		for (int cpu = 0; (cpu < CPU_SETSIZE) && (numberOfCpus < maxNumberOfCpus); cpu++)
+		{
+			if (CPU_ISSET(cpu, &allowedCpus))
+			{
+				cpus[numberOfCpus++] = cpu;
+			}
+		}
+	}
+#endif
+
+	return numberOfCpus;
+}
+
+static bool
+isCpuInList(int  cpu, const int *  cpus, size_t  numberOfCpus)
+{
+	for (size_t i = 0; i < numberOfCpus; i++)
+	{
+		if (cpus[i] == cpu)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ *	@brief	Order the allowed CPUs round-robin across NUMA nodes, as read from sysfs.
+ *
+ *	Consecutive threads then land on different nodes. Without NUMA information, this is the
+ *	ascending order of the allowed CPUs.
+ */
+static size_t
+getScatteredCpus(int *  cpus, size_t  maxNumberOfCpus)
+{
+	static int	nodeCpus[kParallelMonteCarloMaxNumberOfNodes][kThreadAffinityMaxNumberOfCpus];
+	size_t		numberOfNodeCpus[kParallelMonteCarloMaxNumberOfNodes] = {0};
+	int		allowedCpus[kThreadAffinityMaxNumberOfCpus];
+	size_t		numberOfAllowedCpus = getAllowedCpus(allowedCpus, kThreadAffinityMaxNumberOfCpus);
+	size_t		numberOfNodes = 0;
+	size_t		numberOfCpus = 0;
+
+	for (int node = 0; node < kParallelMonteCarloMaxNumberOfNodes; node++)
+	{
+		char	path[kCommonConstantMaxCharsPerFilepath];
+		char	cpuList[kParallelMonteCarloMaxCharsPerCpuList];
+		int	cpusOfNode[kThreadAffinityMaxNumberOfCpus];
+		size_t	numberOfCpusOfNode;
+		FILE *	file;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+		file = fopen(path, "r");
+
+		if (file == NULL)
+		{
+			continue;
+		}
+
+		if ((fgets(cpuList, sizeof(cpuList), file) != NULL) &&
+			(parseCpuList(cpuList, cpusOfNode, kThreadAffinityMaxNumberOfCpus, &numberOfCpusOfNode) == kCommonConstantReturnTypeSuccess))
+		{
+			for (size_t i = 0; i < numberOfCpusOfNode; i++)
+			{
+				if (isCpuInList(cpusOfNode[i], allowedCpus, numberOfAllowedCpus))
+				{
+					nodeCpus[numberOfNodes][numberOfNodeCpus[numberOfNodes]++] = cpusOfNode[i];
+				}
+			}
+
+			numberOfNodes += (numberOfNodeCpus[numberOfNodes] > 0) ? 1 : 0;
+		}
+
+		fclose(file);
+	}
+
+	if (numberOfNodes == 0)
+	{
+		memcpy(cpus, allowedCpus, numberOfAllowedCpus * sizeof(int));
+
+		return numberOfAllowedCpus;
+	}
+
+	for (size_t round = 0; numberOfCpus < maxNumberOfCpus; round++)
+	{
+		size_t	numberOfCpusInRound = 0;
+
+		for (size_t node = 0; (node < numberOfNodes) && (numberOfCpus < maxNumberOfCpus); node++)
+		{
+			if (round < numberOfNodeCpus[node])
+			{
+				cpus[numberOfCpus++] = nodeCpus[node][round];
+				numberOfCpusInRound++;
+			}
+		}
+
+		if (numberOfCpusInRound == 0)
+		{
+			break;
+		}
+	}
+
+	return numberOfCpus;
+}
+
+static void
+pinCurrentThread(int  cpu)
+{
+#if defined(__linux__)
+	cpu_set_t	cpuSet;
+
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+	{
+		fprintf(stderr, "Warning: Could not pin a worker thread to CPU %d.\n", cpu);
+	}
+#else
+	(void) cpu;
+#endif
+
+	return;
+}
+
+static void *
+runParallelMonteCarloWorker(void *  argument)
+{
+	ParallelMonteCarloWorker *	worker = (ParallelMonteCarloWorker *) argument;
+	CommandLineArguments *		arguments = worker->arguments;
+	double *			inputVariables[kInputDistributionIndexMax];
+	double				outputDistributions[kOutputDistributionIndexMax];
+	SamplingStream			stream;
+	FusedKernel			fusedKernel;
+
+	/*
+	 *	Pin first, so that the pages touched below are placed on the node of the worker's CPU.
+	 */
+	if (worker->cpu >= 0)
+	{
+		pinCurrentThread(worker->cpu);
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		inputVariables[i] = (double *) checkedMalloc(kParallelMonteCarloInputBatchSize * arguments->numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+		memset(inputVariables[i], 0, kParallelMonteCarloInputBatchSize * arguments->numberOfYearsToRetirement * sizeof(double));
+	}
+
+	if (arguments->isFusedKernelEnabled)
+	{
+		initFusedKernel(&fusedKernel, arguments);
+	}
+
+	memset(&worker->samples[worker->firstIteration], 0, (worker->endIteration - worker->firstIteration) * sizeof(double));
+
+	for (size_t batchStart = worker->firstIteration; batchStart < worker->endIteration; batchStart += kParallelMonteCarloInputBatchSize)
+	{
+		size_t	batchLength = worker->endIteration - batchStart;
+
+		if (batchLength > kParallelMonteCarloInputBatchSize)
+		{
+			batchLength = kParallelMonteCarloInputBatchSize;
+		}
+
+		if ((batchStart % kParallelMonteCarloBlockSize) == 0)
+		{
+			initSamplingStream(&stream, arguments->seed, batchStart / kParallelMonteCarloBlockSize);
+		}
+
+		/*
+		 *	Draw the inputs of the whole batch first, so that the correlated sampler can work on
+		 *	all of its paths at once. The samples are the same as when drawing path by path.
+		 */
+		if (!arguments->isFusedKernelEnabled)
+		{
+			setInputVariablesBatchFromStream(arguments, &stream, batchLength, inputVariables);
+		}
+
+		for (size_t path = 0; path < batchLength; path++)
+		{
+			size_t	i = batchStart + path;
+
+			if (arguments->isFusedKernelEnabled)
+			{
+				runFusedKernel(&fusedKernel, &stream, outputDistributions, NULL);
+			}
+			else
+			{
+				double *	pathInputVariables[kInputDistributionIndexMax];
+
+				for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+				{
+					pathInputVariables[j] = &inputVariables[j][path * arguments->numberOfYearsToRetirement];
+				}
+
+				worker->calculateOutputFunction(arguments, arguments->numberOfYearsToRetirement, pathInputVariables, outputDistributions);
+			}
+			worker->samples[i] = outputDistributions[arguments->common.outputSelect];
+
+			if (worker->progressCounter != NULL)
+			{
+				recordProgressSample(worker->progressCounter, worker->samples[i]);
+			}
+		}
+	}
+
+	if (worker->progressCounter != NULL)
+	{
+		publishProgressCounter(worker->progressCounter);
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		free(inputVariables[i]);
+	}
+
+	return NULL;
+}
+
+CommonConstantReturnType
+calculateMonteCarloSamplesInParallel(
+	CommandLineArguments *	arguments,
+	CalculateOutputFunction	calculateOutputFunction,
+	double *		samples,
+	ProgressMetrics *	progressMetrics)
+{
+	size_t				numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	size_t				numberOfBlocks = (numberOfIterations + kParallelMonteCarloBlockSize - 1) / kParallelMonteCarloBlockSize;
+	size_t				numberOfThreads = (size_t) arguments->numberOfThreads;
+	int				cpus[kThreadAffinityMaxNumberOfCpus];
+	size_t				numberOfCpus = 0;
+	ParallelMonteCarloWorker *	workers;
+	pthread_t *			threads;
+	CommonConstantReturnType	result = kCommonConstantReturnTypeSuccess;
+
+	switch (arguments->threadAffinity.policy)
+	{
+		case kThreadAffinityPolicyCompact:
+			numberOfCpus = getAllowedCpus(cpus, kThreadAffinityMaxNumberOfCpus);
+			break;
+		case kThreadAffinityPolicyScatter:
+			numberOfCpus = getScatteredCpus(cpus, kThreadAffinityMaxNumberOfCpus);
+			break;
+		case kThreadAffinityPolicyList:
+			numberOfCpus = arguments->threadAffinity.numberOfCpus;
+			memcpy(cpus, arguments->threadAffinity.cpus, numberOfCpus * sizeof(int));
+			break;
+		default:
+			break;
+	}
+
+	/*
+	 *	Workers get whole blocks, so that each block is drawn from a single stream.
+	 */
+	numberOfThreads = (numberOfThreads > numberOfBlocks) ? numberOfBlocks : numberOfThreads;
+	numberOfThreads = (numberOfThreads == 0) ? 1 : numberOfThreads;
+	workers = (ParallelMonteCarloWorker *) checkedMalloc(numberOfThreads * sizeof(ParallelMonteCarloWorker), __FILE__, __LINE__);
+	threads = (pthread_t *) checkedMalloc(numberOfThreads * sizeof(pthread_t), __FILE__, __LINE__);
+
+	for (size_t i = 0; i < numberOfThreads; i++)
+	{
+		size_t	firstBlock = numberOfBlocks * i / numberOfThreads;
+		size_t	endBlock = numberOfBlocks * (i + 1) / numberOfThreads;
+
+		workers[i].arguments = arguments;
+		workers[i].calculateOutputFunction = calculateOutputFunction;
+		workers[i].samples = samples;
+		workers[i].progressCounter = (progressMetrics != NULL) ? &progressMetrics->counters[i] : NULL;
+		workers[i].firstIteration = firstBlock * kParallelMonteCarloBlockSize;
+		workers[i].endIteration = (endBlock * kParallelMonteCarloBlockSize > numberOfIterations) ? numberOfIterations : endBlock * kParallelMonteCarloBlockSize;
+		workers[i].cpu = (numberOfCpus > 0) ? cpus[i % numberOfCpus] : -1;
+	}
+
+	for (size_t i = 0; i < numberOfThreads; i++)
+	{
+		if (pthread_create(&threads[i], NULL, runParallelMonteCarloWorker, &workers[i]) != 0)
+		{
+			fprintf(stderr, "Error: Could not create worker thread %zu.\n", i);
+			numberOfThreads = i;
+			result = kCommonConstantReturnTypeError;
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < numberOfThreads; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	free(workers);
+
+	return result;
+}
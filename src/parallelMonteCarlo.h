@@ -0,0 +1,92 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "kernel.h"
+#include "progressMetrics.h"
+#include "utilities.h"
+
+
+enum
+{
+	/*
+	 *	Number of iterations per sampling stream. Iteration `i` draws from stream `i / kParallelMonteCarloBlockSize`.
+	 */
+	kParallelMonteCarloBlockSize = 4096,
+
+	/*
+	 *	Number of paths whose inputs are drawn together. A divisor of `kParallelMonteCarloBlockSize`,
+	 *	so that no batch spans two sampling streams.
+	 */
+	kParallelMonteCarloInputBatchSize = 32,
+};
+
+/**
+ *	@brief	Parse a list of CPUs, e.g., "0,2,4-7".
+ *
+ *	@param	string			: The string to parse.
+ *	@param	cpus			: Array to store the CPUs, in the order of the list.
+ *	@param	maxNumberOfCpus		: Capacity of `cpus`.
+ *	@param	numberOfCpus		: Pointer to store the number of CPUs parsed.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	parseCpuList(
+					const char *	string,
+					int *		cpus,
+					size_t		maxNumberOfCpus,
+					size_t *	numberOfCpus);
+
+/**
+ *	@brief	Allocate a buffer for samples, without touching its pages.
+ *
+ *	The pages are placed on the NUMA node of the thread that first writes them. With huge pages,
+ *	the buffer is aligned to, and advised to be backed by, transparent huge pages.
+ *
+ *	@param	numberOfSamples		: Number of samples.
+ *	@param	useHugePages		: Whether to back the buffer with transparent huge pages.
+ *	@return				: The buffer, to be released with `free()`.
+ */
+double *	allocateSampleBuffer(
+			size_t	numberOfSamples,
+			bool	useHugePages);
+
+/**
+ *	@brief	Calculate the Monte Carlo output samples with `-p` pinned worker threads.
+ *
+ *	Each worker pins itself according to the affinity policy, first-touches its contiguous slice
+ *	of `samples` and its own input arrays, so that both are placed on its NUMA node, and fills its
+ *	slice. Samples are drawn from one stream per block of iterations, so they do not depend on the
+ *	number of threads or their placement.
+ *
+ *	@param	arguments			: Pointer to command-line arguments struct.
+ *	@param	calculateOutputFunction		: The process kernel.
+ *	@param	samples				: Buffer for `numberOfMonteCarloIterations` output samples.
+ *	@param	progressMetrics			: Progress metrics with one counter per thread, or `NULL`.
+ *	@return					: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	calculateMonteCarloSamplesInParallel(
+					CommandLineArguments *	arguments,
+					CalculateOutputFunction	calculateOutputFunction,
+					double *		samples,
+					ProgressMetrics *	progressMetrics);
@@ -0,0 +1,353 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "progressMetrics.h"
+#include "timeBudget.h"
+
+
+/*
+ *	Period with which the reporter thread checks for snapshot requests and for the end of the run.
+ */
+#define kProgressMetricsTickInSeconds	(0.01)
+
+static const char *	kProgressPhaseNames[kProgressPhaseMax] =
+			{
+				"setup",
+				"sampling",
+				"postprocessing",
+				"output",
+			};
+
+/*
+ *	Set by the SIGUSR1 handler, and cleared by the reporter thread when it takes the snapshot.
+ */
+static volatile sig_atomic_t	gIsProgressSnapshotRequested = 0;
+static struct sigaction		gPreviousSigusr1Action;
+
+typedef struct
+{
+	uint64_t	numberOfSamples;
+	double		mean;
+	double		standardError;
+	double		iterationsPerSecond;
+	double		phaseDuration[kProgressPhaseMax];
+	int		phase;
+} ProgressSnapshot;
+
+static void
+handleSigusr1(int  signalNumber)
+{
+	(void) signalNumber;
+	gIsProgressSnapshotRequested = 1;
+
+	return;
+}
+
+/**
+ *	@brief	Read the published state of a counter, retrying reads that overlap a publication.
+ */
+static void
+readProgressCounter(
+	ProgressCounter *	counter,
+	uint64_t *		numberOfSamples,
+	double *		mean,
+	double *		sumOfSquaredDeviations)
+{
+	uint64_t	sequenceBefore;
+	uint64_t	sequenceAfter;
+
+	do
+	{
+		sequenceBefore = atomic_load_explicit(&counter->sequence, memory_order_acquire);
+		*numberOfSamples = atomic_load_explicit(&counter->publishedNumberOfSamples, memory_order_relaxed);
+		*mean = atomic_load_explicit(&counter->publishedMean, memory_order_relaxed);
+		*sumOfSquaredDeviations = atomic_load_explicit(&counter->publishedSumOfSquaredDeviations, memory_order_relaxed);
+		atomic_thread_fence(memory_order_acquire);
+		sequenceAfter = atomic_load_explicit(&counter->sequence, memory_order_relaxed);
+	} while ((sequenceBefore != sequenceAfter) || ((sequenceBefore & 1) != 0));
+
+	return;
+}
+
+/**
+ *	@brief	Aggregate the counters of all threads, combining their means and variances pairwise.
+ */
+static void
+takeProgressSnapshot(ProgressMetrics *  progressMetrics, ProgressSnapshot *  snapshot)
+{
+	double	now = getMonotonicTimeInSeconds();
+	double	sumOfSquaredDeviations = 0.0;
+
+	memset(snapshot, 0, sizeof(ProgressSnapshot));
+
+	for (size_t i = 0; i < progressMetrics->numberOfCounters; i++)
+	{
+		uint64_t	numberOfSamples;
+		double		mean;
+		double		counterSumOfSquaredDeviations;
+		uint64_t	combinedNumberOfSamples;
+		double		deviation;
+
+		readProgressCounter(&progressMetrics->counters[i], &numberOfSamples, &mean, &counterSumOfSquaredDeviations);
+
+		if (numberOfSamples == 0)
+		{
+			continue;
+		}
+
+		combinedNumberOfSamples = snapshot->numberOfSamples + numberOfSamples;
+		deviation = mean - snapshot->mean;
+		snapshot->mean += deviation * numberOfSamples / combinedNumberOfSamples;
+		sumOfSquaredDeviations +=
+			counterSumOfSquaredDeviations +
+			deviation * deviation * ((double) snapshot->numberOfSamples * numberOfSamples / combinedNumberOfSamples);
+		snapshot->numberOfSamples = combinedNumberOfSamples;
+	}
+
+	snapshot->standardError = (snapshot->numberOfSamples > 1) ?
+					sqrt(sumOfSquaredDeviations / (snapshot->numberOfSamples - 1) / snapshot->numberOfSamples) :
+					NAN;
+	snapshot->phase = atomic_load(&progressMetrics->phase);
+
+	for (int phase = 0; phase < kProgressPhaseMax; phase++)
+	{
+		double	startTime = atomic_load(&progressMetrics->phaseStartTime[phase]);
+		double	endTime = atomic_load(&progressMetrics->phaseEndTime[phase]);
+
+		if (startTime >= 0.0)
+		{
+			snapshot->phaseDuration[phase] = ((endTime >= 0.0) ? endTime : now) - startTime;
+		}
+	}
+
+	snapshot->iterationsPerSecond = (snapshot->phaseDuration[kProgressPhaseSampling] > 0.0) ?
+						(snapshot->numberOfSamples / snapshot->phaseDuration[kProgressPhaseSampling]) :
+						0.0;
+
+	return;
+}
+
+/**
+ *	@brief	Write a snapshot in the Prometheus text format, replacing the file atomically.
+ */
+static void
+writePrometheusFile(ProgressMetrics *  progressMetrics, ProgressSnapshot *  snapshot)
+{
+	CommandLineArguments *	arguments = progressMetrics->arguments;
+	const char *		outputName = kOutputVariableNames[arguments->common.outputSelect];
+	char			temporaryPath[kCommonConstantMaxCharsPerFilepath + 8];
+	FILE *			file;
+
+	snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", arguments->metricsFilePath);
+	file = fopen(temporaryPath, "w");
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Warning: Could not open metrics file \"%s\".\n", temporaryPath);
+
+		return;
+	}
+
+	fprintf(file, "# HELP ira_iterations_completed_total Monte Carlo iterations completed.\n");
+	fprintf(file, "# TYPE ira_iterations_completed_total counter\n");
+	fprintf(file, "ira_iterations_completed_total %" PRIu64 "\n", snapshot->numberOfSamples);
+	fprintf(file, "# HELP ira_iterations_requested Monte Carlo iterations requested.\n");
+	fprintf(file, "# TYPE ira_iterations_requested gauge\n");
+	fprintf(file, "ira_iterations_requested %" PRIu64 "\n", progressMetrics->numberOfIterations);
+	fprintf(file, "# HELP ira_iterations_per_second Monte Carlo iterations per second since the start of sampling.\n");
+	fprintf(file, "# TYPE ira_iterations_per_second gauge\n");
+	fprintf(file, "ira_iterations_per_second %.17g\n", snapshot->iterationsPerSecond);
+	fprintf(file, "# HELP ira_output_mean Running mean of the selected output.\n");
+	fprintf(file, "# TYPE ira_output_mean gauge\n");
+	fprintf(file, "ira_output_mean{output=\"%s\"} %.17g\n", outputName, snapshot->mean);
+	fprintf(file, "# HELP ira_output_standard_error Standard error of the running mean of the selected output.\n");
+	fprintf(file, "# TYPE ira_output_standard_error gauge\n");
+	fprintf(file, "ira_output_standard_error{output=\"%s\"} %.17g\n", outputName, snapshot->standardError);
+	fprintf(file, "# HELP ira_phase_duration_seconds Wall-clock time spent in each phase so far.\n");
+	fprintf(file, "# TYPE ira_phase_duration_seconds gauge\n");
+
+	for (int phase = 0; phase < kProgressPhaseMax; phase++)
+	{
+		fprintf(file, "ira_phase_duration_seconds{phase=\"%s\"} %.9f\n", kProgressPhaseNames[phase], snapshot->phaseDuration[phase]);
+	}
+
+	fprintf(file, "# HELP ira_phase_active Whether the run is in the phase.\n");
+	fprintf(file, "# TYPE ira_phase_active gauge\n");
+
+	for (int phase = 0; phase < kProgressPhaseMax; phase++)
+	{
+		fprintf(file, "ira_phase_active{phase=\"%s\"} %d\n", kProgressPhaseNames[phase], (phase == snapshot->phase) ? 1 : 0);
+	}
+
+	if ((fclose(file) != 0) || (rename(temporaryPath, arguments->metricsFilePath) != 0))
+	{
+		fprintf(stderr, "Warning: Could not write metrics file \"%s\".\n", arguments->metricsFilePath);
+	}
+
+	return;
+}
+
+static void
+reportProgress(ProgressMetrics *  progressMetrics)
+{
+	ProgressSnapshot	snapshot;
+
+	takeProgressSnapshot(progressMetrics, &snapshot);
+
+	if (progressMetrics->arguments->isProgressToStderrEnabled)
+	{
+		fprintf(
+			stderr,
+			"Progress: %" PRIu64 "/%" PRIu64 " iterations (%.1lf%%), %.3le iterations/s, mean %.6le, standard error %.3le, phase %s.\n",
+			snapshot.numberOfSamples,
+			progressMetrics->numberOfIterations,
+			100.0 * snapshot.numberOfSamples / progressMetrics->numberOfIterations,
+			snapshot.iterationsPerSecond,
+			snapshot.mean,
+			snapshot.standardError,
+			(snapshot.phase < kProgressPhaseMax) ? kProgressPhaseNames[snapshot.phase] : "finished");
+	}
+
+	if (progressMetrics->arguments->isMetricsFileSet)
+	{
+		writePrometheusFile(progressMetrics, &snapshot);
+	}
+
+	return;
+}
+
+static void *
+runProgressReporter(void *  argument)
+{
+	ProgressMetrics *	progressMetrics = (ProgressMetrics *) argument;
+	double			nextReportTime = getMonotonicTimeInSeconds() + progressMetrics->arguments->progressIntervalInSeconds;
+	struct timespec		tick =
+				{
+					.tv_sec = 0,
+					.tv_nsec = (long)(kProgressMetricsTickInSeconds * 1e9),
+				};
+
+	while (!atomic_load(&progressMetrics->isStopRequested))
+	{
+		double	now;
+
+		nanosleep(&tick, NULL);
+		now = getMonotonicTimeInSeconds();
+
+		if (gIsProgressSnapshotRequested || (now >= nextReportTime))
+		{
+			gIsProgressSnapshotRequested = 0;
+			nextReportTime = now + progressMetrics->arguments->progressIntervalInSeconds;
+			reportProgress(progressMetrics);
+		}
+	}
+
+	return NULL;
+}
+
+CommonConstantReturnType
+startProgressMetrics(
+	ProgressMetrics *	progressMetrics,
+	CommandLineArguments *	arguments,
+	size_t			numberOfCounters,
+	double			startTime)
+{
+	struct sigaction	action;
+
+	memset(progressMetrics, 0, sizeof(ProgressMetrics));
+	progressMetrics->arguments = arguments;
+	progressMetrics->numberOfCounters = numberOfCounters;
+	progressMetrics->numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	progressMetrics->counters = (ProgressCounter *) aligned_alloc(kProgressMetricsCacheLineSize, numberOfCounters * sizeof(ProgressCounter));
+
+	if (progressMetrics->counters == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate progress counters.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	memset(progressMetrics->counters, 0, numberOfCounters * sizeof(ProgressCounter));
+
+	for (int phase = 0; phase < kProgressPhaseMax; phase++)
+	{
+		atomic_store(&progressMetrics->phaseStartTime[phase], -1.0);
+		atomic_store(&progressMetrics->phaseEndTime[phase], -1.0);
+	}
+
+	atomic_store(&progressMetrics->phase, kProgressPhaseSetup);
+	atomic_store(&progressMetrics->phaseStartTime[kProgressPhaseSetup], startTime);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handleSigusr1;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &action, &gPreviousSigusr1Action);
+
+	if (pthread_create(&progressMetrics->reporter, NULL, runProgressReporter, progressMetrics) != 0)
+	{
+		fprintf(stderr, "Error: Could not create the progress reporter thread.\n");
+		sigaction(SIGUSR1, &gPreviousSigusr1Action, NULL);
+		free(progressMetrics->counters);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+setProgressPhase(
+	ProgressMetrics *	progressMetrics,
+	ProgressPhase		phase)
+{
+	double	now = getMonotonicTimeInSeconds();
+
+	atomic_store(&progressMetrics->phaseEndTime[atomic_load(&progressMetrics->phase)], now);
+	atomic_store(&progressMetrics->phaseStartTime[phase], now);
+	atomic_store(&progressMetrics->phase, phase);
+
+	return;
+}
+
+void
+stopProgressMetrics(ProgressMetrics *  progressMetrics)
+{
+	atomic_store(&progressMetrics->phaseEndTime[atomic_load(&progressMetrics->phase)], getMonotonicTimeInSeconds());
+	atomic_store(&progressMetrics->phase, kProgressPhaseMax);
+	atomic_store(&progressMetrics->isStopRequested, true);
+	pthread_join(progressMetrics->reporter, NULL);
+	sigaction(SIGUSR1, &gPreviousSigusr1Action, NULL);
+
+	reportProgress(progressMetrics);
+
+	free(progressMetrics->counters);
+	progressMetrics->counters = NULL;
+
+	return;
+}
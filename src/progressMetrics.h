@@ -0,0 +1,165 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "utilities.h"
+
+
+/**
+ *	Number of samples that a progress counter accumulates privately between two publications.
+ */
+enum
+{
+	kProgressMetricsPublishInterval	= 1024,
+	kProgressMetricsCacheLineSize	= 64,
+};
+
+typedef enum
+{
+	kProgressPhaseSetup		= 0,
+	kProgressPhaseSampling		= 1,
+	kProgressPhasePostProcessing	= 2,
+	kProgressPhaseOutput		= 3,
+	kProgressPhaseMax		= 4,
+} ProgressPhase;
+
+/**
+ *	Counter of a single thread, on its own cache line. The owning thread accumulates samples in
+ *	the private fields, and periodically publishes them under a sequence lock, so that neither side
+ *	ever blocks: the reporter retries a read that overlaps a publication.
+ */
+typedef struct
+{
+	_Alignas(kProgressMetricsCacheLineSize)
+	uint64_t		numberOfSamples;
+	double			mean;
+	double			sumOfSquaredDeviations;
+
+	_Atomic uint64_t	sequence;
+	_Atomic uint64_t	publishedNumberOfSamples;
+	_Atomic double		publishedMean;
+	_Atomic double		publishedSumOfSquaredDeviations;
+} ProgressCounter;
+
+typedef struct
+{
+	CommandLineArguments *	arguments;
+	ProgressCounter *	counters;
+	size_t			numberOfCounters;
+	uint64_t		numberOfIterations;
+
+	/*
+	 *	The current phase, or `kProgressPhaseMax` once the run has finished.
+	 */
+	_Atomic int		phase;
+	_Atomic double		phaseStartTime[kProgressPhaseMax];
+	_Atomic double		phaseEndTime[kProgressPhaseMax];
+
+	_Atomic bool		isStopRequested;
+	pthread_t		reporter;
+} ProgressMetrics;
+
+/**
+ *	@brief	Publish the privately accumulated samples of a counter.
+ *
+ *	@param	counter		: Pointer to the counter, owned by the calling thread.
+ */
+static inline void
+publishProgressCounter(ProgressCounter *  counter)
+{
+	uint64_t	sequence = atomic_load_explicit(&counter->sequence, memory_order_relaxed);
+
+	atomic_store_explicit(&counter->sequence, sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&counter->publishedNumberOfSamples, counter->numberOfSamples, memory_order_relaxed);
+	atomic_store_explicit(&counter->publishedMean, counter->mean, memory_order_relaxed);
+	atomic_store_explicit(&counter->publishedSumOfSquaredDeviations, counter->sumOfSquaredDeviations, memory_order_relaxed);
+	atomic_store_explicit(&counter->sequence, sequence + 2, memory_order_release);
+
+	return;
+}
+
+/**
+ *	@brief	Add an output sample to the counter of the calling thread.
+ *
+ *	Only every `kProgressMetricsPublishInterval`-th sample touches shared state.
+ *
+ *	@param	counter		: Pointer to the counter, owned by the calling thread.
+ *	@param	sample		: The output sample.
+ */
+static inline void
+recordProgressSample(ProgressCounter *  counter, double  sample)
+{
+	double	deviation = sample - counter->mean;
+
+	counter->numberOfSamples++;
+	counter->mean += deviation / counter->numberOfSamples;
+	counter->sumOfSquaredDeviations += deviation * (sample - counter->mean);
+
+	if ((counter->numberOfSamples % kProgressMetricsPublishInterval) == 0)
+	{
+		publishProgressCounter(counter);
+	}
+
+	return;
+}
+
+/**
+ *	@brief	Start collecting progress metrics, and the reporter thread that exposes them.
+ *
+ *	The reporter writes a snapshot every `-P` seconds, and immediately on SIGUSR1, to the
+ *	Prometheus text-format file of `-E` and/or to stderr (`-D`).
+ *
+ *	@param	progressMetrics		: Pointer to the progress metrics to start.
+ *	@param	arguments		: Pointer to command-line arguments struct.
+ *	@param	numberOfCounters	: Number of counters, one per thread that records samples.
+ *	@param	startTime		: Monotonic time at which the setup phase started, in seconds.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	startProgressMetrics(
+					ProgressMetrics *	progressMetrics,
+					CommandLineArguments *	arguments,
+					size_t			numberOfCounters,
+					double			startTime);
+
+/**
+ *	@brief	Enter a new phase of the run.
+ *
+ *	@param	progressMetrics		: Pointer to the progress metrics.
+ *	@param	phase			: The phase to enter.
+ */
+void	setProgressPhase(
+		ProgressMetrics *	progressMetrics,
+		ProgressPhase		phase);
+
+/**
+ *	@brief	Stop the reporter thread after a final snapshot, and release the counters.
+ *
+ *	@param	progressMetrics		: Pointer to the progress metrics.
+ */
+void	stopProgressMetrics(ProgressMetrics *  progressMetrics);
@@ -0,0 +1,591 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "sampleArchive.h"
+#include "statistics.h"
+
+
+/*
+ *	Quantized samples must fit in an int64_t with room for the differences of consecutive ones.
+ */
+#define kSampleArchiveMaxQuantizedMagnitude	(4611686018427387904.0)
+
+static const char	kSampleArchiveMagic[8] = "IRASARC";
+
+enum
+{
+	kSampleArchiveVersion			= 1,
+	kSampleArchiveBlockSize			= 4096,
+	kSampleArchiveHeaderSize		= 48,
+	kSampleArchiveIndexEntrySize		= 16,
+	kSampleArchiveMaxVarintSize		= 10,
+	kSampleArchiveUnpackBlocksPerRead	= 64,
+};
+
+/**
+ *	Encoding of a contiguous range of blocks, by one thread, into its own buffer.
+ */
+typedef struct
+{
+	const double *	sortedSamples;
+	size_t		numberOfSamples;
+	double		quantum;
+	size_t		firstBlock;
+	size_t		endBlock;
+	size_t *	blockLengths;
+	int64_t *	firstQuantizedSamples;
+	unsigned char *	buffer;
+	size_t		bufferLength;
+	size_t		bufferCapacity;
+	bool		isValid;
+} SampleArchiveEncodeTask;
+
+/*
+ *	All fields of an archive are little-endian, so that archives are portable across machines.
+ */
+static void
+storeUint32(unsigned char *  bytes, uint32_t  value)
+{
+	for (size_t i = 0; i < 4; i++)
+	{
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	return;
+}
+
+static void
+storeUint64(unsigned char *  bytes, uint64_t  value)
+{
+	for (size_t i = 0; i < 8; i++)
+	{
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	return;
+}
+
+static uint32_t
+loadUint32(const unsigned char *  bytes)
+{
+	uint32_t	value = 0;
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		value |= (uint32_t) bytes[i] << (8 * i);
+	}
+
+	return value;
+}
+
+static uint64_t
+loadUint64(const unsigned char *  bytes)
+{
+	uint64_t	value = 0;
+
+	for (size_t i = 0; i < 8; i++)
+	{
+		value |= (uint64_t) bytes[i] << (8 * i);
+	}
+
+	return value;
+}
+
+static void *
+encodeSampleArchiveBlocks(void *  argument)
+{
+	SampleArchiveEncodeTask *	task = (SampleArchiveEncodeTask *) argument;
+
+	for (size_t block = task->firstBlock; block < task->endBlock; block++)
+	{
+		size_t	begin = block * kSampleArchiveBlockSize;
+		size_t	end = (begin + kSampleArchiveBlockSize < task->numberOfSamples) ? begin + kSampleArchiveBlockSize : task->numberOfSamples;
+		size_t	blockStart = task->bufferLength;
+		int64_t	previous = 0;
+
+		/*
+		 *	Grow the buffer to hold the block in the worst case.
+		 */
+		if (task->bufferLength + (end - begin) * kSampleArchiveMaxVarintSize > task->bufferCapacity)
+		{
+			size_t		capacity = 2 * task->bufferCapacity + (end - begin) * kSampleArchiveMaxVarintSize;
+			unsigned char *	buffer = (unsigned char *) checkedMalloc(capacity, __FILE__, __LINE__);
+
+			if (task->buffer != NULL)
+			{
+				memcpy(buffer, task->buffer, task->bufferLength);
+			}
+
+			free(task->buffer);
+			task->buffer = buffer;
+			task->bufferCapacity = capacity;
+		}
+
+		for (size_t i = begin; i < end; i++)
+		{
+			double		scaledSample = task->sortedSamples[i] / task->quantum;
+			int64_t		quantizedSample;
+			uint64_t	delta;
+
+			if (!(fabs(scaledSample) < kSampleArchiveMaxQuantizedMagnitude))
+			{
+				task->isValid = false;
+
+				return NULL;
+			}
+
+			quantizedSample = (int64_t) llround(scaledSample);
+
+			if (i == begin)
+			{
+				task->firstQuantizedSamples[block] = quantizedSample;
+				previous = quantizedSample;
+
+				continue;
+			}
+
+			/*
+			 *	The samples are sorted and rounding is monotonic, so the differences are not negative.
+			 */
+			delta = (uint64_t)(quantizedSample - previous);
+			previous = quantizedSample;
+
+			while (delta >= 0x80)
+			{
+				task->buffer[task->bufferLength++] = (unsigned char)(delta | 0x80);
+				delta >>= 7;
+			}
+
+			task->buffer[task->bufferLength++] = (unsigned char) delta;
+		}
+
+		task->blockLengths[block] = task->bufferLength - blockStart;
+	}
+
+	return NULL;
+}
+
+CommonConstantReturnType
+writeSampleArchive(
+	const char *	path,
+	const double *	samples,
+	size_t		numberOfSamples,
+	double		quantum,
+	int		numberOfThreads)
+{
+	size_t				numberOfBlocks = (numberOfSamples + kSampleArchiveBlockSize - 1) / kSampleArchiveBlockSize;
+	size_t				numberOfTasks = (numberOfThreads > 1) ? (size_t) numberOfThreads : 1;
+	double *			sortedSamples;
+	size_t *			blockLengths;
+	int64_t *			firstQuantizedSamples;
+	SampleArchiveEncodeTask *	tasks;
+	pthread_t *			threads;
+	unsigned char			header[kSampleArchiveHeaderSize] = {0};
+	unsigned char			indexEntry[kSampleArchiveIndexEntrySize];
+	uint64_t			offset = kSampleArchiveHeaderSize;
+	uint64_t			quantumBits;
+	bool				isValid = true;
+	bool				isWritten;
+	FILE *				file;
+
+	numberOfTasks = (numberOfTasks < numberOfBlocks) ? numberOfTasks : ((numberOfBlocks > 0) ? numberOfBlocks : 1);
+
+	sortedSamples = (double *) checkedMalloc((numberOfSamples > 0 ? numberOfSamples : 1) * sizeof(double), __FILE__, __LINE__);
+	blockLengths = (size_t *) checkedMalloc((numberOfBlocks + 1) * sizeof(size_t), __FILE__, __LINE__);
+	firstQuantizedSamples = (int64_t *) checkedMalloc((numberOfBlocks + 1) * sizeof(int64_t), __FILE__, __LINE__);
+	tasks = (SampleArchiveEncodeTask *) checkedMalloc(numberOfTasks * sizeof(SampleArchiveEncodeTask), __FILE__, __LINE__);
+	threads = (pthread_t *) checkedMalloc(numberOfTasks * sizeof(pthread_t), __FILE__, __LINE__);
+
+	memcpy(sortedSamples, samples, numberOfSamples * sizeof(double));
+	sortDoubleSamplesInParallel(sortedSamples, numberOfSamples, numberOfThreads);
+
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		tasks[i] = (SampleArchiveEncodeTask){
+				.sortedSamples = sortedSamples,
+				.numberOfSamples = numberOfSamples,
+				.quantum = quantum,
+				.firstBlock = (numberOfBlocks * i) / numberOfTasks,
+				.endBlock = (numberOfBlocks * (i + 1)) / numberOfTasks,
+				.blockLengths = blockLengths,
+				.firstQuantizedSamples = firstQuantizedSamples,
+				.buffer = NULL,
+				.bufferLength = 0,
+				.bufferCapacity = 0,
+				.isValid = true,
+			};
+	}
+
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (pthread_create(&threads[i], NULL, encodeSampleArchiveBlocks, &tasks[i]) != 0)
+		{
+			/*
+			 *	Fall back to encoding the blocks on the calling thread.
+			 */
+			encodeSampleArchiveBlocks(&tasks[i]);
+			threads[i] = pthread_self();
+		}
+	}
+
+	encodeSampleArchiveBlocks(&tasks[0]);
+
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (!pthread_equal(threads[i], pthread_self()))
+		{
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		isValid = isValid && tasks[i].isValid;
+		offset += tasks[i].bufferLength;
+	}
+
+	if (!isValid)
+	{
+		fprintf(stderr, "Error: The samples cannot be quantized to multiples of %le for the archive \"%s\".\n", quantum, path);
+	}
+
+	/*
+	 *	Header: magic, version, block size, quantum, number of samples, number of blocks, and the
+	 *	offset of the index, which follows the blocks.
+	 */
+	memcpy(&quantumBits, &quantum, sizeof(quantumBits));
+	memcpy(header, kSampleArchiveMagic, sizeof(kSampleArchiveMagic));
+	storeUint32(&header[8], kSampleArchiveVersion);
+	storeUint32(&header[12], kSampleArchiveBlockSize);
+	storeUint64(&header[16], quantumBits);
+	storeUint64(&header[24], numberOfSamples);
+	storeUint64(&header[32], numberOfBlocks);
+	storeUint64(&header[40], offset);
+
+	file = isValid ? fopen(path, "wb") : NULL;
+	isWritten = (file != NULL) && (fwrite(header, sizeof(header), 1, file) == 1);
+
+	for (size_t i = 0; isWritten && (i < numberOfTasks); i++)
+	{
+		isWritten = (fwrite(tasks[i].buffer, 1, tasks[i].bufferLength, file) == tasks[i].bufferLength);
+	}
+
+	offset = kSampleArchiveHeaderSize;
+
+	for (size_t block = 0; isWritten && (block < numberOfBlocks); block++)
+	{
+		storeUint64(&indexEntry[0], offset);
+		storeUint64(&indexEntry[8], (uint64_t) firstQuantizedSamples[block]);
+		isWritten = (fwrite(indexEntry, sizeof(indexEntry), 1, file) == 1);
+		offset += blockLengths[block];
+	}
+
+	if (file != NULL)
+	{
+		isWritten = (fclose(file) == 0) && isWritten;
+	}
+
+	if (isValid && !isWritten)
+	{
+		fprintf(stderr, "Error: Could not write the sample archive \"%s\".\n", path);
+	}
+
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		free(tasks[i].buffer);
+	}
+
+	free(threads);
+	free(tasks);
+	free(firstQuantizedSamples);
+	free(blockLengths);
+	free(sortedSamples);
+
+	return (isValid && isWritten) ? kCommonConstantReturnTypeSuccess : kCommonConstantReturnTypeError;
+}
+
+static CommonConstantReturnType
+readSampleArchiveHeaderFromFile(FILE *  file, const char *  path, SampleArchiveHeader *  header)
+{
+	unsigned char	bytes[kSampleArchiveHeaderSize];
+	uint64_t	quantumBits;
+
+	if ((fread(bytes, sizeof(bytes), 1, file) != 1) ||
+		(memcmp(bytes, kSampleArchiveMagic, sizeof(kSampleArchiveMagic)) != 0) ||
+		(loadUint32(&bytes[8]) != kSampleArchiveVersion))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a sample archive of this version.\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	quantumBits = loadUint64(&bytes[16]);
+	memcpy(&header->quantum, &quantumBits, sizeof(header->quantum));
+	header->blockSize = loadUint32(&bytes[12]);
+	header->numberOfSamples = loadUint64(&bytes[24]);
+	header->numberOfBlocks = loadUint64(&bytes[32]);
+	header->indexOffset = loadUint64(&bytes[40]);
+
+	if ((header->blockSize == 0) || !(header->quantum > 0.0) ||
+		(header->numberOfBlocks != (header->numberOfSamples + header->blockSize - 1) / header->blockSize) ||
+		(header->indexOffset < kSampleArchiveHeaderSize))
+	{
+		fprintf(stderr, "Error: The header of the sample archive \"%s\" is corrupt.\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+readSampleArchiveHeader(
+	const char *		path,
+	SampleArchiveHeader *	header)
+{
+	FILE *				file = fopen(path, "rb");
+	CommonConstantReturnType	ret;
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open the sample archive \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	ret = readSampleArchiveHeaderFromFile(file, path, header);
+	fclose(file);
+
+	return ret;
+}
+
+/**
+ *	@brief	Decode one block and store the samples of the block that fall in the requested range of
+ *		ranks.
+ */
+static bool
+decodeSampleArchiveBlock(
+	const unsigned char *	bytes,
+	size_t			numberOfBytes,
+	int64_t			firstQuantizedSample,
+	double			quantum,
+	uint64_t		blockBegin,
+	uint64_t		blockEnd,
+	uint64_t		firstSample,
+	uint64_t		endSample,
+	double *		samples)
+{
+	int64_t		quantizedSample = firstQuantizedSample;
+	size_t		position = 0;
+
+	for (uint64_t rank = blockBegin; rank < blockEnd; rank++)
+	{
+		if (rank > blockBegin)
+		{
+			uint64_t	delta = 0;
+			unsigned	shift = 0;
+			unsigned char	byte;
+
+			do
+			{
+				if ((position == numberOfBytes) || (shift >= 7 * kSampleArchiveMaxVarintSize))
+				{
+					return false;
+				}
+
+				byte = bytes[position++];
+				delta |= (uint64_t)(byte & 0x7f) << shift;
+				shift += 7;
+			} while (byte & 0x80);
+
+			quantizedSample = (int64_t)((uint64_t) quantizedSample + delta);
+		}
+
+		if (rank >= endSample)
+		{
+			break;
+		}
+
+		if (rank >= firstSample)
+		{
+			samples[rank - firstSample] = (double) quantizedSample * quantum;
+		}
+	}
+
+	return true;
+}
+
+CommonConstantReturnType
+readSampleArchiveRange(
+	const char *	path,
+	uint64_t	firstSample,
+	uint64_t	numberOfSamples,
+	double *	samples)
+{
+	SampleArchiveHeader	header;
+	FILE *			file = fopen(path, "rb");
+	unsigned char *		bytes = NULL;
+	size_t			bytesCapacity = 0;
+	uint64_t		endSample;
+	bool			isRead = true;
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open the sample archive \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (readSampleArchiveHeaderFromFile(file, path, &header) != kCommonConstantReturnTypeSuccess)
+	{
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((firstSample > header.numberOfSamples) || (numberOfSamples > header.numberOfSamples - firstSample))
+	{
+		fprintf(stderr, "Error: The range of samples is outside the %" PRIu64 " samples of the archive \"%s\".\n", header.numberOfSamples, path);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	endSample = firstSample + numberOfSamples;
+
+	for (uint64_t block = firstSample / header.blockSize; isRead && (block * header.blockSize < endSample); block++)
+	{
+		unsigned char	indexEntries[2 * kSampleArchiveIndexEntrySize];
+		uint64_t	blockOffset;
+		uint64_t	nextBlockOffset;
+		uint64_t	blockBegin = block * header.blockSize;
+		uint64_t	blockEnd = (blockBegin + header.blockSize < header.numberOfSamples) ? blockBegin + header.blockSize : header.numberOfSamples;
+		size_t		numberOfIndexEntries = (block + 1 < header.numberOfBlocks) ? 2 : 1;
+
+		/*
+		 *	The offset of the next block, or of the index for the last block, bounds this block.
+		 */
+		isRead = (fseeko(file, (off_t)(header.indexOffset + block * kSampleArchiveIndexEntrySize), SEEK_SET) == 0) &&
+				(fread(indexEntries, kSampleArchiveIndexEntrySize, numberOfIndexEntries, file) == numberOfIndexEntries);
+
+		if (!isRead)
+		{
+			break;
+		}
+
+		blockOffset = loadUint64(&indexEntries[0]);
+		nextBlockOffset = (numberOfIndexEntries == 2) ? loadUint64(&indexEntries[kSampleArchiveIndexEntrySize]) : header.indexOffset;
+		isRead = (blockOffset >= kSampleArchiveHeaderSize) && (nextBlockOffset >= blockOffset) && (nextBlockOffset <= header.indexOffset);
+
+		if (isRead && (nextBlockOffset - blockOffset > bytesCapacity))
+		{
+			bytesCapacity = nextBlockOffset - blockOffset;
+			free(bytes);
+			bytes = (unsigned char *) checkedMalloc(bytesCapacity, __FILE__, __LINE__);
+		}
+
+		isRead = isRead &&
+				(fseeko(file, (off_t) blockOffset, SEEK_SET) == 0) &&
+				(fread(bytes, 1, nextBlockOffset - blockOffset, file) == nextBlockOffset - blockOffset) &&
+				decodeSampleArchiveBlock(
+					bytes,
+					nextBlockOffset - blockOffset,
+					(int64_t) loadUint64(&indexEntries[8]),
+					header.quantum,
+					blockBegin,
+					blockEnd,
+					firstSample,
+					endSample,
+					samples);
+	}
+
+	if (!isRead)
+	{
+		fprintf(stderr, "Error: The sample archive \"%s\" is truncated or corrupt.\n", path);
+	}
+
+	free(bytes);
+	fclose(file);
+
+	return isRead ? kCommonConstantReturnTypeSuccess : kCommonConstantReturnTypeError;
+}
+
+CommonConstantReturnType
+runSampleArchiveUnpackMode(CommandLineArguments *  arguments)
+{
+	SampleArchiveHeader	header;
+	uint64_t		firstSample = 0;
+	uint64_t		numberOfSamples;
+	uint64_t		numberOfSamplesPerRead;
+	double *		samples;
+	int			numberOfDecimals;
+
+	if (readSampleArchiveHeader(arguments->unpackFilePath, &header) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	numberOfSamples = header.numberOfSamples;
+
+	if (arguments->isUnpackRangeSet)
+	{
+		firstSample = arguments->unpackRangeFirstSample;
+		numberOfSamples = arguments->unpackRangeNumberOfSamples;
+	}
+
+	/*
+	 *	Print as many decimals as the quantum has, e.g., two for cents.
+	 */
+	numberOfDecimals = (header.quantum < 1.0) ? (int) ceil(-log10(header.quantum) - 1e-9) : 0;
+	numberOfDecimals = (numberOfDecimals < 17) ? numberOfDecimals : 17;
+
+	numberOfSamplesPerRead = (uint64_t) kSampleArchiveUnpackBlocksPerRead * header.blockSize;
+	samples = (double *) checkedMalloc(numberOfSamplesPerRead * sizeof(double), __FILE__, __LINE__);
+
+	for (uint64_t done = 0; done < numberOfSamples; done += numberOfSamplesPerRead)
+	{
+		uint64_t	numberOfSamplesToRead = (numberOfSamples - done < numberOfSamplesPerRead) ? numberOfSamples - done : numberOfSamplesPerRead;
+
+		if (readSampleArchiveRange(arguments->unpackFilePath, firstSample + done, numberOfSamplesToRead, samples) != kCommonConstantReturnTypeSuccess)
+		{
+			free(samples);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		for (uint64_t i = 0; i < numberOfSamplesToRead; i++)
+		{
+			printf("%.*lf\n", numberOfDecimals, samples[i]);
+		}
+	}
+
+	free(samples);
+
+	return kCommonConstantReturnTypeSuccess;
+}
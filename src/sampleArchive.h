@@ -0,0 +1,98 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "utilities.h"
+
+
+/**
+ *	Header of a sample archive, as read back from the file.
+ */
+typedef struct
+{
+	uint32_t	blockSize;
+	double		quantum;
+	uint64_t	numberOfSamples;
+	uint64_t	numberOfBlocks;
+	uint64_t	indexOffset;
+} SampleArchiveHeader;
+
+/**
+ *	@brief	Write samples to a compressed archive.
+ *
+ *	The samples are sorted, quantized to integer multiples of `quantum`, and split into blocks of
+ *	a fixed number of samples. Each block stores the differences of consecutive quantized samples
+ *	as variable-length integers, and decodes independently of the others: the index at the end
+ *	of the file holds the offset and the first quantized sample of every block. The blocks are
+ *	encoded in parallel. The archive keeps the distribution of the samples, not their order.
+ *
+ *	@param	path		: Path to the archive file.
+ *	@param	samples		: The samples, which are left unchanged.
+ *	@param	numberOfSamples	: Number of samples.
+ *	@param	quantum		: The precision of the stored samples (e.g., 0.01 for cents).
+ *	@param	numberOfThreads	: Number of threads to use.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	writeSampleArchive(
+					const char *	path,
+					const double *	samples,
+					size_t		numberOfSamples,
+					double		quantum,
+					int		numberOfThreads);
+
+/**
+ *	@brief	Read the header of a sample archive.
+ *
+ *	@param	path	: Path to the archive file.
+ *	@param	header	: Pointer to store the header.
+ *	@return		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	readSampleArchiveHeader(
+					const char *		path,
+					SampleArchiveHeader *	header);
+
+/**
+ *	@brief	Read a range of samples, by rank, from a sample archive. Only the blocks that overlap the
+ *		range are read and decoded.
+ *
+ *	@param	path			: Path to the archive file.
+ *	@param	firstSample		: Rank of the first sample to read, from 0 (the smallest).
+ *	@param	numberOfSamples		: Number of samples to read.
+ *	@param	samples			: Array of at least `numberOfSamples` elements to store the samples.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	readSampleArchiveRange(
+					const char *	path,
+					uint64_t	firstSample,
+					uint64_t	numberOfSamples,
+					double *	samples);
+
+/**
+ *	@brief	Run the unpack mode: print the samples of a range of ranks of a sample archive, one per
+ *		line, to stdout.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runSampleArchiveUnpackMode(CommandLineArguments *  arguments);
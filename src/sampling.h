@@ -0,0 +1,96 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define kDefaultSamplingSeed	(UINT64_C(0x5349474e414c4f49))
+
+/**
+ *	State of an independent stream of pseudo-random numbers (xoshiro256**).
+ *
+ *	The UxHw compatibility layer draws from a single, process-wide generator, so it cannot be
+ *	shared between threads. Native multi-threaded modes instead give each unit of work its own
+ *	stream, derived from a seed and a stream index, which also makes their results independent of
+ *	scheduling.
+ */
+typedef struct
+{
+	uint64_t	state[4];
+} SamplingStream;
+
+/**
+ *	@brief	Initialize a sampling stream.
+ *
+ *	@param	stream		: Pointer to the stream to initialize.
+ *	@param	seed		: The seed shared by all streams of a run.
+ *	@param	streamIndex	: Index of this stream within the run.
+ */
+void	initSamplingStream(
+		SamplingStream *	stream,
+		uint64_t		seed,
+		uint64_t		streamIndex);
+
+/**
+ *	@brief	Draw a sample from Uniform(min, max).
+ *
+ *	@param	stream	: Pointer to the sampling stream.
+ *	@param	min	: Lower bound.
+ *	@param	max	: Upper bound.
+ *	@return		: The sample.
+ */
+double	samplingStreamUniform(
+		SamplingStream *	stream,
+		double			min,
+		double			max);
+
+/**
+ *	@brief	Draw a sample from Gauss(mean, standardDeviation).
+ *
+ *	@param	stream			: Pointer to the sampling stream.
+ *	@param	mean			: Mean.
+ *	@param	standardDeviation	: Standard deviation.
+ *	@return				: The sample.
+ */
+double	samplingStreamGauss(
+		SamplingStream *	stream,
+		double			mean,
+		double			standardDeviation);
+
+/**
+ *	@brief	Fill an array with samples from Gauss(0, 1).
+ *
+ *	Uses the ziggurat method, which takes a single draw and no transcendental function for
+ *	about 99% of samples, instead of the Box-Muller transform of `samplingStreamGauss()`. The two
+ *	therefore give different samples from the same stream.
+ *
+ *	@param	stream		: Pointer to the sampling stream.
+ *	@param	values		: Array of `numberOfValues` samples to fill.
+ *	@param	numberOfValues	: Number of samples.
+ */
+void	samplingStreamStandardGaussBatch(
+		SamplingStream *	stream,
+		double *		values,
+		size_t			numberOfValues);
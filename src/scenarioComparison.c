@@ -0,0 +1,334 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "scenarioComparison.h"
+#include "kernel.h"
+#include "specializedKernels.h"
+#include "statistics.h"
+
+
+#define kScenarioComparisonConfidenceIntervalZ	(1.959963984540054)
+
+/*
+ *	Keys of the specification of scenario B, and the inputs they set (or `kInputDistributionIndexMax`).
+ */
+static const struct
+{
+	const char *		key;
+	InputDistributionIndex	input;
+} kScenarioSpecificationKeys[] =
+{
+	{ "t", kInputDistributionIndexTotalAnnualContributionToAccount },
+	{ "c", kInputDistributionIndexCompoundedAnnualInterestRate },
+	{ "w", kInputDistributionIndexWithdrawalRate },
+	{ "r", kInputDistributionIndexAssumedTaxRateOnInterest },
+	{ "m", kInputDistributionIndexMax },
+	{ "S", kInputDistributionIndexMax },
+};
+
+/**
+ *	Running mean and sum of squared deviations (Welford).
+ */
+typedef struct
+{
+	double	mean;
+	double	sumOfSquaredDeviations;
+} RunningMoments;
+
+static void
+addToRunningMoments(RunningMoments *  runningMoments, double  sample, size_t  numberOfSamples)
+{
+	double	delta = sample - runningMoments->mean;
+
+	runningMoments->mean += delta / (double) numberOfSamples;
+	runningMoments->sumOfSquaredDeviations += delta * (sample - runningMoments->mean);
+
+	return;
+}
+
+CommonConstantReturnType
+applyScenarioSpecification(
+	CommandLineArguments *	arguments,
+	const char *		specification)
+{
+	char	copy[kCommonConstantMaxCharsPerLine];
+	char *	saveptr = NULL;
+	int	ret = snprintf(copy, sizeof(copy), "%s", specification);
+
+	if ((ret < 0) || (ret >= (int) sizeof(copy)))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (char * token = strtok_r(copy, ",", &saveptr); token != NULL; token = strtok_r(NULL, ",", &saveptr))
+	{
+		char *	value = strchr(token, '=');
+		char *	end;
+		double	number;
+		size_t	k;
+
+		if (value == NULL)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		*value++ = '\0';
+
+		for (k = 0; k < sizeof(kScenarioSpecificationKeys) / sizeof(kScenarioSpecificationKeys[0]); k++)
+		{
+			if (strcmp(token, kScenarioSpecificationKeys[k].key) == 0)
+			{
+				break;
+			}
+		}
+
+		errno = 0;
+		number = strtod(value, &end);
+
+		if ((k == sizeof(kScenarioSpecificationKeys) / sizeof(kScenarioSpecificationKeys[0])) || (end == value) || (*end != '\0') || (errno != 0) || !isfinite(number))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (kScenarioSpecificationKeys[k].input != kInputDistributionIndexMax)
+		{
+			snprintf(arguments->inputVariablesUxStrings[kScenarioSpecificationKeys[k].input], kCommonConstantMaxCharsPerLine, "%s", value);
+			arguments->isInputVariableSet[kScenarioSpecificationKeys[k].input] = true;
+		}
+		else if (strcmp(token, "m") == 0)
+		{
+			if ((number < 1.0) || (number > INT32_MAX) || (number != floor(number)))
+			{
+				return kCommonConstantReturnTypeError;
+			}
+
+			arguments->periodsPerYear = (int) number;
+		}
+		else
+		{
+			if ((number < 0.0) || (number >= kOutputDistributionIndexMax) || (number != floor(number)))
+			{
+				return kCommonConstantReturnTypeError;
+			}
+
+			arguments->common.outputSelect = (OutputDistributionIndex) number;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+runScenarioComparisonMode(CommandLineArguments *  arguments)
+{
+	CommandLineArguments *	argumentsB;
+	size_t			numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+	int			numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+	double *		inputVariables[kInputDistributionIndexMax];
+	double *		inputVariablesB[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	double			outputDistributionsB[kOutputDistributionIndexMax];
+	CalculateOutputFunction	calculateOutputFunction;
+	CalculateOutputFunction	calculateOutputFunctionB;
+	double *		differences;
+	double *		sortedDifferences;
+	RunningMoments		momentsA = {0};
+	RunningMoments		momentsB = {0};
+	RunningMoments		momentsOfDifference = {0};
+	size_t			numberOfPathsBetterInB = 0;
+	double			varianceA;
+	double			varianceB;
+	double			varianceOfDifference;
+	double			standardErrorOfDifference;
+	double			probabilityBetterInB;
+	double			varianceReductionFactor;
+	double			cpuTimeUsedInSeconds;
+	clock_t			start;
+
+	/*
+	 *	`CommandLineArguments` is large, so the copy for scenario B lives on the heap.
+	 */
+	argumentsB = (CommandLineArguments *) checkedMalloc(sizeof(CommandLineArguments), __FILE__, __LINE__);
+	*argumentsB = *arguments;
+
+	if (applyScenarioSpecification(argumentsB, arguments->scenarioSpecification) != kCommonConstantReturnTypeSuccess)
+	{
+		fprintf(stderr, "Error: Malformed specification of scenario B \"%s\".\n", arguments->scenarioSpecification);
+		free(argumentsB);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Inputs that scenario B overrides are constant, and set once. The others point to the inputs
+	 *	of scenario A, which the kernels only read, so both scenarios see the same draws.
+	 */
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		inputVariables[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+		inputVariablesB[j] = inputVariables[j];
+
+		if (argumentsB->isInputVariableSet[j] && (!arguments->isInputVariableSet[j] ||
+			(strcmp(argumentsB->inputVariablesUxStrings[j], arguments->inputVariablesUxStrings[j]) != 0)))
+		{
+			double	value = 0.0;
+
+			sscanf(argumentsB->inputVariablesUxStrings[j], "%lf", &value);
+			inputVariablesB[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+
+			for (int i = 0; i < numberOfYearsToRetirement; i++)
+			{
+				inputVariablesB[j][i] = value;
+			}
+		}
+	}
+
+	/*
+	 *	As in Monte Carlo mode, inputs from a CSV file are read once, except in bootstrap mode.
+	 *	Inputs that scenario B overrides keep their constant values.
+	 */
+	if (arguments->common.isInputFromFileEnabled && !arguments->inputBootstrap.isEnabled)
+	{
+		if (prepareCSVInputVariables(arguments, inputVariables) != kCommonConstantReturnTypeSuccess)
+		{
+			for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+			{
+				if (inputVariablesB[j] != inputVariables[j])
+				{
+					free(inputVariablesB[j]);
+				}
+
+				free(inputVariables[j]);
+			}
+
+			free(argumentsB);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	differences = (double *) checkedMalloc(numberOfIterations * sizeof(double), __FILE__, __LINE__);
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, numberOfYearsToRetirement);
+	calculateOutputFunctionB = selectCalculateOutputFunction(argumentsB, numberOfYearsToRetirement);
+
+	start = clock();
+
+	for (size_t i = 0; i < numberOfIterations; i++)
+	{
+		double	outputA;
+		double	outputB;
+
+		if (!arguments->common.isInputFromFileEnabled || arguments->inputBootstrap.isEnabled)
+		{
+			setInputVariables(arguments, inputVariables);
+		}
+
+		calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+		calculateOutputFunctionB(argumentsB, numberOfYearsToRetirement, inputVariablesB, outputDistributionsB);
+
+		outputA = outputDistributions[arguments->common.outputSelect];
+		outputB = outputDistributionsB[argumentsB->common.outputSelect];
+		differences[i] = outputB - outputA;
+		numberOfPathsBetterInB += (outputB > outputA) ? 1 : 0;
+
+		addToRunningMoments(&momentsA, outputA, i + 1);
+		addToRunningMoments(&momentsB, outputB, i + 1);
+		addToRunningMoments(&momentsOfDifference, differences[i], i + 1);
+	}
+
+	/*
+	 *	Independent runs of A and B would estimate the difference of the means with variance
+	 *	(Var(A) + Var(B)) / M, and paired runs with Var(B - A) / M. Their ratio is the factor by
+	 *	which common random numbers cut the number of iterations for a given standard error.
+	 */
+	varianceA = (numberOfIterations > 1) ? momentsA.sumOfSquaredDeviations / (double)(numberOfIterations - 1) : 0.0;
+	varianceB = (numberOfIterations > 1) ? momentsB.sumOfSquaredDeviations / (double)(numberOfIterations - 1) : 0.0;
+	varianceOfDifference = (numberOfIterations > 1) ? momentsOfDifference.sumOfSquaredDeviations / (double)(numberOfIterations - 1) : 0.0;
+	standardErrorOfDifference = sqrt(varianceOfDifference / (double) numberOfIterations);
+	probabilityBetterInB = (double) numberOfPathsBetterInB / (double) numberOfIterations;
+	varianceReductionFactor = (varianceOfDifference > 0.0) ? (varianceA + varianceB) / varianceOfDifference : INFINITY;
+
+	sortedDifferences = (double *) checkedMalloc(numberOfIterations * sizeof(double), __FILE__, __LINE__);
+	memcpy(sortedDifferences, differences, numberOfIterations * sizeof(double));
+	sortDoubleSamplesInParallel(sortedDifferences, numberOfIterations, arguments->numberOfThreads);
+
+	cpuTimeUsedInSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %lf %" PRIu64 "\n", momentsOfDifference.mean, probabilityBetterInB, (uint64_t)(cpuTimeUsedInSeconds * 1000000));
+	}
+	else
+	{
+		printf("Scenario A (%s): mean $%.2lf.\n", kOutputVariableNames[arguments->common.outputSelect], momentsA.mean);
+		printf("Scenario B (%s, %s): mean $%.2lf.\n", kOutputVariableNames[argumentsB->common.outputSelect], arguments->scenarioSpecification, momentsB.mean);
+		printf(
+			"Difference B - A: mean $%.2lf (95%% confidence interval [$%.2lf, $%.2lf]), 5th percentile $%.2lf, median $%.2lf, 95th percentile $%.2lf.\n",
+			momentsOfDifference.mean,
+			momentsOfDifference.mean - kScenarioComparisonConfidenceIntervalZ * standardErrorOfDifference,
+			momentsOfDifference.mean + kScenarioComparisonConfidenceIntervalZ * standardErrorOfDifference,
+			sortedDifferences[(size_t)(0.05 * (double)(numberOfIterations - 1))],
+			sortedDifferences[(size_t)(0.5 * (double)(numberOfIterations - 1))],
+			sortedDifferences[(size_t)(0.95 * (double)(numberOfIterations - 1))]);
+		printf(
+			"P(B > A) = %lf (standard error %lf).\n",
+			probabilityBetterInB,
+			sqrt(probabilityBetterInB * (1.0 - probabilityBetterInB) / (double) numberOfIterations));
+		printf(
+			"Common random numbers reduce the variance of the difference by a factor of %.1lf over independent runs of A and B.\n",
+			varianceReductionFactor);
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedInSeconds);
+		}
+	}
+
+	/*
+	 *	As in Monte Carlo mode, "data.out" holds the samples, here of the difference B - A.
+	 */
+	saveMonteCarloDoubleDataToDataDotOutFile(differences, (uint64_t)(cpuTimeUsedInSeconds * 1000000), numberOfIterations);
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		if (inputVariablesB[j] != inputVariables[j])
+		{
+			free(inputVariablesB[j]);
+		}
+
+		free(inputVariables[j]);
+	}
+
+	free(sortedDifferences);
+	free(differences);
+	free(argumentsB);
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,53 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Apply the specification of scenario B to a copy of the arguments of scenario A.
+ *
+ *	The specification is a comma-separated list of `key=value` overrides, with the keys of the
+ *	corresponding command-line options: `t`, `c`, `r` and `w` set an input to a constant, `m` sets
+ *	the number of compounding periods per year, and `S` selects the output (e.g., `t=8000,S=1`).
+ *
+ *	@param	arguments	: Pointer to the arguments to override.
+ *	@param	specification	: The specification of scenario B.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	applyScenarioSpecification(
+					CommandLineArguments *	arguments,
+					const char *		specification);
+
+/**
+ *	@brief	Run the comparison mode: evaluate scenarios A and B on the same sampled inputs, and
+ *		report the distribution of the difference B - A and P(B > A).
+ *
+ *	Inputs that scenario B does not override are shared with scenario A on every path (common
+ *	random numbers), so the noise common to both scenarios cancels in the difference.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct (scenario A).
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runScenarioComparisonMode(CommandLineArguments *  arguments);
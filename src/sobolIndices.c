@@ -0,0 +1,407 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sobolIndices.h"
+#include "kernel.h"
+#include "parallelMonteCarlo.h"
+#include "sampling.h"
+#include "specializedKernels.h"
+#include "statistics.h"
+#include "timeBudget.h"
+
+
+enum
+{
+	kSobolNumberOfBootstrapResamples	= 500,
+	/*
+	 *	First-order and total-effect index of each input.
+	 */
+	kSobolNumberOfIndices			= 2 * kInputDistributionIndexMax,
+};
+
+/*
+ *	The bootstrap resamples draw from sampling streams far after those of the base samples.
+ */
+#define kSobolBootstrapStreamIndexOffset	(UINT64_C(1) << 32)
+
+/**
+ *	Evaluations of the kernel on the rows of A, B, and AB_j, for each input j.
+ */
+typedef struct
+{
+	double *	outputsA;
+	double *	outputsB;
+	double *	outputsAB[kInputDistributionIndexMax];
+} SobolEvaluations;
+
+/**
+ *	Work of one thread: the base samples of a range of blocks, then a range of bootstrap resamples.
+ */
+typedef struct
+{
+	CommandLineArguments *	arguments;
+	CalculateOutputFunction	calculateOutputFunction;
+	SobolEvaluations *	evaluations;
+	size_t			numberOfBaseSamples;
+	size_t			firstBlock;
+	size_t			endBlock;
+	double			outputMean;
+	size_t			firstResample;
+	size_t			endResample;
+	double *		resampledIndices;
+} SobolTask;
+
+/**
+ *	@brief	Estimate the indices from a set of base samples, given by their indices, or all of them
+ *		in order if `sampleIndices` is `NULL`.
+ *
+ *	The outputs are centered on the mean of the outputs of A and B, which leaves the indices
+ *	unchanged in expectation but reduces the variance of the first-order estimator (Saltelli et
+ *	al., 2010). The total-effect estimator is Jansen's.
+ */
+static void
+estimateSobolIndices(
+	const SobolEvaluations *	evaluations,
+	const size_t *			sampleIndices,
+	size_t				numberOfBaseSamples,
+	double				outputMean,
+	double *			indices)
+{
+	double	sumOfOutputs = 0.0;
+	double	sumOfSquaredOutputs = 0.0;
+	double	firstOrderSums[kInputDistributionIndexMax] = {0};
+	double	totalEffectSums[kInputDistributionIndexMax] = {0};
+	double	variance;
+
+	for (size_t i = 0; i < numberOfBaseSamples; i++)
+	{
+		size_t	sample = (sampleIndices != NULL) ? sampleIndices[i] : i;
+		double	outputA = evaluations->outputsA[sample] - outputMean;
+		double	outputB = evaluations->outputsB[sample] - outputMean;
+
+		sumOfOutputs += outputA + outputB;
+		sumOfSquaredOutputs += outputA * outputA + outputB * outputB;
+
+		for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			double	outputAB = evaluations->outputsAB[j][sample] - outputMean;
+
+			firstOrderSums[j] += outputB * (outputAB - outputA);
+			totalEffectSums[j] += (outputA - outputAB) * (outputA - outputAB);
+		}
+	}
+
+	variance = sumOfSquaredOutputs / (double)(2 * numberOfBaseSamples) -
+			(sumOfOutputs / (double)(2 * numberOfBaseSamples)) * (sumOfOutputs / (double)(2 * numberOfBaseSamples));
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		indices[j] = (variance > 0.0) ? firstOrderSums[j] / (double) numberOfBaseSamples / variance : 0.0;
+		indices[kInputDistributionIndexMax + j] = (variance > 0.0) ? totalEffectSums[j] / (double)(2 * numberOfBaseSamples) / variance : 0.0;
+	}
+
+	return;
+}
+
+static void *
+evaluateSobolBaseSamples(void *  argument)
+{
+	SobolTask *		task = (SobolTask *) argument;
+	CommandLineArguments *	arguments = task->arguments;
+	size_t			numberOfYearsToRetirement = (size_t) arguments->numberOfYearsToRetirement;
+	double *		inputVariablesA[kInputDistributionIndexMax];
+	double *		inputVariablesB[kInputDistributionIndexMax];
+	double *		inputVariablesAB[kInputDistributionIndexMax];
+	double			outputDistributions[kOutputDistributionIndexMax];
+	SamplingStream		stream;
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		inputVariablesA[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+		inputVariablesB[j] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+	}
+
+	for (size_t block = task->firstBlock; block < task->endBlock; block++)
+	{
+		size_t	begin = block * kParallelMonteCarloBlockSize;
+		size_t	end = (begin + kParallelMonteCarloBlockSize < task->numberOfBaseSamples) ? begin + kParallelMonteCarloBlockSize : task->numberOfBaseSamples;
+
+		initSamplingStream(&stream, arguments->seed, block);
+
+		for (size_t i = begin; i < end; i++)
+		{
+			setInputVariablesFromStream(arguments, &stream, inputVariablesA);
+			setInputVariablesFromStream(arguments, &stream, inputVariablesB);
+
+			task->calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariablesA, outputDistributions);
+			task->evaluations->outputsA[i] = outputDistributions[arguments->common.outputSelect];
+			task->calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariablesB, outputDistributions);
+			task->evaluations->outputsB[i] = outputDistributions[arguments->common.outputSelect];
+
+			/*
+			 *	The rows of AB_j need no copies: they point to the groups of A, except for the
+			 *	group of input j, which points to that of B.
+			 */
+			for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+			{
+				for (size_t k = 0; k < kInputDistributionIndexMax; k++)
+				{
+					inputVariablesAB[k] = (k == j) ? inputVariablesB[k] : inputVariablesA[k];
+				}
+
+				task->calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariablesAB, outputDistributions);
+				task->evaluations->outputsAB[j][i] = outputDistributions[arguments->common.outputSelect];
+			}
+		}
+	}
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		free(inputVariablesA[j]);
+		free(inputVariablesB[j]);
+	}
+
+	return NULL;
+}
+
+static void *
+estimateSobolBootstrapResamples(void *  argument)
+{
+	SobolTask *	task = (SobolTask *) argument;
+	size_t *	sampleIndices = (size_t *) checkedMalloc(task->numberOfBaseSamples * sizeof(size_t), __FILE__, __LINE__);
+	SamplingStream	stream;
+
+	for (size_t resample = task->firstResample; resample < task->endResample; resample++)
+	{
+		initSamplingStream(&stream, task->arguments->seed, kSobolBootstrapStreamIndexOffset + resample);
+
+		for (size_t i = 0; i < task->numberOfBaseSamples; i++)
+		{
+			size_t	sample = (size_t)(samplingStreamUniform(&stream, 0.0, 1.0) * (double) task->numberOfBaseSamples);
+
+			sampleIndices[i] = (sample < task->numberOfBaseSamples) ? sample : task->numberOfBaseSamples - 1;
+		}
+
+		estimateSobolIndices(task->evaluations, sampleIndices, task->numberOfBaseSamples, task->outputMean, &task->resampledIndices[resample * kSobolNumberOfIndices]);
+	}
+
+	free(sampleIndices);
+
+	return NULL;
+}
+
+/**
+ *	@brief	Run a function on all tasks, each on its own thread, or on the calling thread if a thread
+ *		cannot be created.
+ */
+static void
+runSobolTasks(void *  (*function)(void *), SobolTask *  tasks, pthread_t *  threads, size_t  numberOfTasks)
+{
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (pthread_create(&threads[i], NULL, function, &tasks[i]) != 0)
+		{
+			function(&tasks[i]);
+			threads[i] = pthread_self();
+		}
+	}
+
+	function(&tasks[0]);
+
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (!pthread_equal(threads[i], pthread_self()))
+		{
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	return;
+}
+
+CommonConstantReturnType
+runSobolIndicesMode(CommandLineArguments *  arguments)
+{
+	size_t			numberOfBaseSamples = arguments->common.numberOfMonteCarloIterations;
+	size_t			numberOfBlocks = (numberOfBaseSamples + kParallelMonteCarloBlockSize - 1) / kParallelMonteCarloBlockSize;
+	size_t			numberOfTasks = (arguments->numberOfThreads > 1) ? (size_t) arguments->numberOfThreads : 1;
+	CalculateOutputFunction	calculateOutputFunction;
+	SobolEvaluations	evaluations;
+	SobolTask *		tasks;
+	pthread_t *		threads;
+	double			indices[kSobolNumberOfIndices];
+	double *		resampledIndices;
+	double *		sortedResampledIndices;
+	double			confidenceIntervals[kSobolNumberOfIndices][2];
+	double			outputMean = 0.0;
+	double			outputVariance = 0.0;
+	double			startTime;
+	double			wallClockTimeInSeconds;
+
+	if (numberOfBaseSamples < 2)
+	{
+		fprintf(stderr, "Error: Sensitivity mode requires at least 2 base samples (-M).\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	evaluations.outputsA = (double *) checkedMalloc(numberOfBaseSamples * sizeof(double), __FILE__, __LINE__);
+	evaluations.outputsB = (double *) checkedMalloc(numberOfBaseSamples * sizeof(double), __FILE__, __LINE__);
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		evaluations.outputsAB[j] = (double *) checkedMalloc(numberOfBaseSamples * sizeof(double), __FILE__, __LINE__);
+	}
+
+	tasks = (SobolTask *) checkedMalloc(numberOfTasks * sizeof(SobolTask), __FILE__, __LINE__);
+	threads = (pthread_t *) checkedMalloc(numberOfTasks * sizeof(pthread_t), __FILE__, __LINE__);
+	resampledIndices = (double *) checkedMalloc(kSobolNumberOfBootstrapResamples * kSobolNumberOfIndices * sizeof(double), __FILE__, __LINE__);
+	sortedResampledIndices = (double *) checkedMalloc(kSobolNumberOfBootstrapResamples * sizeof(double), __FILE__, __LINE__);
+
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, (size_t) arguments->numberOfYearsToRetirement);
+
+	/*
+	 *	Wall-clock time, as CPU time adds up over the threads.
+	 */
+	startTime = getMonotonicTimeInSeconds();
+
+	/*
+	 *	Block `b` of base samples draws its rows of A and B from sampling stream `b`, so the
+	 *	evaluations do not depend on the number of threads.
+	 */
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		tasks[i] = (SobolTask){
+				.arguments = arguments,
+				.calculateOutputFunction = calculateOutputFunction,
+				.evaluations = &evaluations,
+				.numberOfBaseSamples = numberOfBaseSamples,
+				.firstBlock = (numberOfBlocks * i) / numberOfTasks,
+				.endBlock = (numberOfBlocks * (i + 1)) / numberOfTasks,
+				.firstResample = (kSobolNumberOfBootstrapResamples * i) / numberOfTasks,
+				.endResample = (kSobolNumberOfBootstrapResamples * (i + 1)) / numberOfTasks,
+				.resampledIndices = resampledIndices,
+			};
+	}
+
+	runSobolTasks(evaluateSobolBaseSamples, tasks, threads, numberOfTasks);
+
+	for (size_t i = 0; i < numberOfBaseSamples; i++)
+	{
+		outputMean += evaluations.outputsA[i] + evaluations.outputsB[i];
+	}
+
+	outputMean /= (double)(2 * numberOfBaseSamples);
+
+	for (size_t i = 0; i < numberOfBaseSamples; i++)
+	{
+		outputVariance += (evaluations.outputsA[i] - outputMean) * (evaluations.outputsA[i] - outputMean) +
+					(evaluations.outputsB[i] - outputMean) * (evaluations.outputsB[i] - outputMean);
+	}
+
+	outputVariance /= (double)(2 * numberOfBaseSamples - 1);
+
+	estimateSobolIndices(&evaluations, NULL, numberOfBaseSamples, outputMean, indices);
+
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		tasks[i].outputMean = outputMean;
+	}
+
+	runSobolTasks(estimateSobolBootstrapResamples, tasks, threads, numberOfTasks);
+
+	/*
+	 *	95% percentile confidence intervals over the bootstrap resamples of the base samples.
+	 */
+	for (size_t index = 0; index < kSobolNumberOfIndices; index++)
+	{
+		for (size_t resample = 0; resample < kSobolNumberOfBootstrapResamples; resample++)
+		{
+			sortedResampledIndices[resample] = resampledIndices[resample * kSobolNumberOfIndices + index];
+		}
+
+		sortDoubleSamplesInParallel(sortedResampledIndices, kSobolNumberOfBootstrapResamples, 1);
+		confidenceIntervals[index][0] = sortedResampledIndices[(size_t)(0.025 * (kSobolNumberOfBootstrapResamples - 1))];
+		confidenceIntervals[index][1] = sortedResampledIndices[(size_t)(0.975 * (kSobolNumberOfBootstrapResamples - 1))];
+	}
+
+	wallClockTimeInSeconds = getMonotonicTimeInSeconds() - startTime;
+
+	if (arguments->common.isBenchmarkingMode)
+	{
+		for (size_t index = 0; index < kSobolNumberOfIndices; index++)
+		{
+			printf("%lf ", indices[index]);
+		}
+
+		printf("%" PRIu64 "\n", (uint64_t)(wallClockTimeInSeconds * 1000000));
+	}
+	else
+	{
+		printf(
+			"%s: mean $%.2lf, standard deviation $%.2lf, over %zu base samples (%zu kernel evaluations).\n",
+			kOutputVariableNames[arguments->common.outputSelect],
+			outputMean,
+			sqrt(outputVariance),
+			numberOfBaseSamples,
+			(kInputDistributionIndexMax + 2) * numberOfBaseSamples);
+		printf("Sobol indices, with 95%% bootstrap confidence intervals over %d resamples:\n", kSobolNumberOfBootstrapResamples);
+
+		for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			printf(
+				"\t%s: first-order %.4lf [%.4lf, %.4lf], total-effect %.4lf [%.4lf, %.4lf]\n",
+				kInputCSVHeaders[j],
+				indices[j],
+				confidenceIntervals[j][0],
+				confidenceIntervals[j][1],
+				indices[kInputDistributionIndexMax + j],
+				confidenceIntervals[kInputDistributionIndexMax + j][0],
+				confidenceIntervals[kInputDistributionIndexMax + j][1]);
+		}
+
+		if (arguments->common.isTimingEnabled)
+		{
+			printf("\nWall-clock time used: %lf seconds\n", wallClockTimeInSeconds);
+		}
+	}
+
+	for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		free(evaluations.outputsAB[j]);
+	}
+
+	free(evaluations.outputsB);
+	free(evaluations.outputsA);
+	free(sortedResampledIndices);
+	free(resampledIndices);
+	free(threads);
+	free(tasks);
+
+	return kCommonConstantReturnTypeSuccess;
+}
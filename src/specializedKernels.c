@@ -0,0 +1,158 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "specializedKernels.h"
+
+
+/*
+ *	The per-year steps below must stay in sync with the loop bodies of `calculateFutureValueTaxed()`
+ *	and `calculateFutureValueTaxedWithdrawal()`, so that the specialized kernels are bit-identical
+ *	to the generic ones.
+ */
+#define specializedKernelStepTaxed(i)\
+	futureValueTaxed =\
+		(futureValueTaxed + totalAnnualContributionToAccount[i]) *\
+		(1.0 + ((compoundedAnnualInterestRate[i] / 100) * (1.0 - (assumedTaxRateOnInterest[i] / 100))));
+
+#define specializedKernelStepTaxedWithdrawal(i)\
+	futureValueTaxedWithdrawal =\
+		(futureValueTaxedWithdrawal + totalAnnualContributionToAccount[i] * (1.0 - (withdrawalRate[i] / 100))) *\
+		(1.0 + (compoundedAnnualInterestRate[i] / 100));
+
+#define specializedKernelStepAll(i)\
+	specializedKernelStepTaxed(i)\
+	specializedKernelStepTaxedWithdrawal(i)
+
+#define specializedKernelRepeatBlock(step, base)\
+	step((base) + 0) step((base) + 1) step((base) + 2) step((base) + 3) step((base) + 4)\
+	step((base) + 5) step((base) + 6) step((base) + 7) step((base) + 8) step((base) + 9)
+
+#define specializedKernelRepeat(step, horizon)	specializedKernelRepeat##horizon(step)
+#define specializedKernelRepeat10(step)\
+	specializedKernelRepeatBlock(step, 0)
+#define specializedKernelRepeat20(step)\
+	specializedKernelRepeat10(step) specializedKernelRepeatBlock(step, 10)
+#define specializedKernelRepeat30(step)\
+	specializedKernelRepeat20(step) specializedKernelRepeatBlock(step, 20)
+#define specializedKernelRepeat40(step)\
+	specializedKernelRepeat30(step) specializedKernelRepeatBlock(step, 30)
+
+/*
+ *	Defines `calculateOutput<Selection><horizon>()`, with the same signature as `calculateOutput()`.
+ */
+#define specializedKernelDefine(selection, horizon, storeOutputs)\
+	static void\
+	calculateOutput##selection##horizon(\
+		CommandLineArguments *	arguments,\
+		size_t			numberOfYearsToRetirement,\
+		double *		inputVariables[kInputDistributionIndexMax],\
+		double *		outputDistributions)\
+	{\
+		double *	totalAnnualContributionToAccount = inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount];\
+		double *	compoundedAnnualInterestRate = inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate];\
+		double *	withdrawalRate = inputVariables[kInputDistributionIndexWithdrawalRate];\
+		double *	assumedTaxRateOnInterest = inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest];\
+		double		futureValueTaxed = 0.0;\
+		double		futureValueTaxedWithdrawal = 0.0;\
+\
+		(void) arguments;\
+		(void) numberOfYearsToRetirement;\
+		(void) withdrawalRate;\
+		(void) assumedTaxRateOnInterest;\
+		(void) futureValueTaxed;\
+		(void) futureValueTaxedWithdrawal;\
+\
+		specializedKernelRepeat(specializedKernelStep##selection, horizon)\
+\
+		storeOutputs\
+	}
+
+#define specializedKernelStoreTaxed\
+	outputDistributions[kOutputDistributionIndexFutureValueTaxed] = futureValueTaxed;
+#define specializedKernelStoreTaxedWithdrawal\
+	outputDistributions[kOutputDistributionIndexFutureValueTaxedWithdrawal] = futureValueTaxedWithdrawal;
+#define specializedKernelStoreAll\
+	specializedKernelStoreTaxed\
+	specializedKernelStoreTaxedWithdrawal
+
+#define specializedKernelDefineHorizon(horizon)\
+	specializedKernelDefine(Taxed, horizon, specializedKernelStoreTaxed)\
+	specializedKernelDefine(TaxedWithdrawal, horizon, specializedKernelStoreTaxedWithdrawal)\
+	specializedKernelDefine(All, horizon, specializedKernelStoreAll)
+
+specializedKernelDefineHorizon(10)
+specializedKernelDefineHorizon(20)
+specializedKernelDefineHorizon(30)
+specializedKernelDefineHorizon(40)
+
+typedef struct
+{
+	size_t			numberOfYearsToRetirement;
+
+	/*
+	 *	Indexed by `OutputDistributionIndex`, with `kOutputDistributionIndexMax` meaning all outputs.
+	 */
+	CalculateOutputFunction	functions[kOutputDistributionIndexMax + 1];
+} SpecializedKernel;
+
+#define specializedKernelEntry(horizon)\
+	{\
+		.numberOfYearsToRetirement = horizon,\
+		.functions =\
+		{\
+			[kOutputDistributionIndexFutureValueTaxed]		= calculateOutputTaxed##horizon,\
+			[kOutputDistributionIndexFutureValueTaxedWithdrawal]	= calculateOutputTaxedWithdrawal##horizon,\
+			[kOutputDistributionIndexMax]				= calculateOutputAll##horizon,\
+		},\
+	}
+
+static const SpecializedKernel	kSpecializedKernels[] =
+				{
+					specializedKernelEntry(10),
+					specializedKernelEntry(20),
+					specializedKernelEntry(30),
+					specializedKernelEntry(40),
+				};
+
+CalculateOutputFunction
+selectCalculateOutputFunction(
+	CommandLineArguments *	arguments,
+	size_t			numberOfYearsToRetirement)
+{
+	/*
+	 *	The specialized kernels compound annually.
+	 */
+	if (arguments->periodsPerYear != 1)
+	{
+		return calculateOutput;
+	}
+
+	for (size_t i = 0; i < sizeof(kSpecializedKernels) / sizeof(kSpecializedKernels[0]); i++)
+	{
+		if (kSpecializedKernels[i].numberOfYearsToRetirement == numberOfYearsToRetirement)
+		{
+			return kSpecializedKernels[i].functions[arguments->common.outputSelect];
+		}
+	}
+
+	return calculateOutput;
+}
@@ -0,0 +1,42 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "kernel.h"
+
+
+/**
+ *	@brief	Select the output calculation to run inside the Monte Carlo loop.
+ *
+ *	For the horizons of `kSpecializedKernels` in specializedKernels.c (10, 20, 30 and 40 years) with
+ *	annual compounding, this returns a kernel that is fully unrolled at compile time and computes
+ *	exactly the outputs selected by `arguments->common.outputSelect`, without any per-iteration
+ *	branching. For any other horizon or compounding frequency, it returns `calculateOutput`.
+ *
+ *	@param	arguments			: Pointer to command-line arguments struct.
+ *	@param	numberOfYearsToRetirement	: Number of years to retirement.
+ *	@return					: The function to call in place of `calculateOutput()`.
+ */
+CalculateOutputFunction	selectCalculateOutputFunction(
+				CommandLineArguments *	arguments,
+				size_t			numberOfYearsToRetirement);
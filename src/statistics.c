@@ -0,0 +1,285 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "statistics.h"
+
+
+typedef struct
+{
+	double *	samples;
+	double *	scratch;
+	size_t		begin;
+	size_t		middle;
+	size_t		end;
+} SortTask;
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *) a;
+	double	y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+static void *
+sortChunk(void *  argument)
+{
+	SortTask *	task = (SortTask *) argument;
+
+	qsort(task->samples + task->begin, task->end - task->begin, sizeof(double), compareDoubles);
+
+	return NULL;
+}
+
+/**
+ *	@brief	Merge the sorted ranges [begin, middle) and [middle, end) of `samples` into `scratch`.
+ */
+static void *
+mergeChunks(void *  argument)
+{
+	SortTask *	task = (SortTask *) argument;
+	size_t		i = task->begin;
+	size_t		j = task->middle;
+	size_t		k = task->begin;
+
+	while ((i < task->middle) && (j < task->end))
+	{
+		task->scratch[k++] = (task->samples[j] < task->samples[i]) ? task->samples[j++] : task->samples[i++];
+	}
+
+	memcpy(&task->scratch[k], &task->samples[i], (task->middle - i) * sizeof(double));
+	k += task->middle - i;
+	memcpy(&task->scratch[k], &task->samples[j], (task->end - j) * sizeof(double));
+
+	return NULL;
+}
+
+/**
+ *	@brief	Run `function` on each task, on its own thread except for the first task.
+ */
+static void
+runSortTasks(
+	void *		(*function)(void *),
+	SortTask *	tasks,
+	pthread_t *	threads,
+	size_t		numberOfTasks)
+{
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (pthread_create(&threads[i], NULL, function, &tasks[i]) != 0)
+		{
+			/*
+			 *	Fall back to running the task on the calling thread.
+			 */
+			function(&tasks[i]);
+			threads[i] = pthread_self();
+		}
+	}
+
+	function(&tasks[0]);
+
+	for (size_t i = 1; i < numberOfTasks; i++)
+	{
+		if (!pthread_equal(threads[i], pthread_self()))
+		{
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	return;
+}
+
+CommonConstantReturnType
+readBinaryDoubleSamples(
+	const char *	path,
+	double **	pointerToSamples,
+	size_t *	numberOfSamples)
+{
+	FILE *		file = fopen(path, "rb");
+	long		sizeInBytes;
+	double *	samples;
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open samples file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fseek(file, 0, SEEK_END) != 0) || ((sizeInBytes = ftell(file)) < 0) || (fseek(file, 0, SEEK_SET) != 0))
+	{
+		fprintf(stderr, "Error: Could not determine the size of samples file \"%s\".\n", path);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((sizeInBytes == 0) || ((sizeInBytes % sizeof(double)) != 0))
+	{
+		fprintf(stderr, "Error: Samples file \"%s\" must contain a positive whole number of binary doubles.\n", path);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	*numberOfSamples = sizeInBytes / sizeof(double);
+	samples = (double *) checkedMalloc(*numberOfSamples * sizeof(double), __FILE__, __LINE__);
+
+	if (fread(samples, sizeof(double), *numberOfSamples, file) != *numberOfSamples)
+	{
+		fprintf(stderr, "Error: Could not read samples file \"%s\".\n", path);
+		free(samples);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	fclose(file);
+	*pointerToSamples = samples;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+sortDoubleSamplesInParallel(
+	double *	samples,
+	size_t		numberOfSamples,
+	int		numberOfThreads)
+{
+	size_t		numberOfChunks = (numberOfThreads > 1) ? (size_t) numberOfThreads : 1;
+	size_t *	boundaries;
+	SortTask *	tasks;
+	pthread_t *	threads;
+	double *	scratch;
+	double *	source;
+	double *	destination;
+
+	if ((numberOfChunks == 1) || (numberOfSamples < numberOfChunks))
+	{
+		qsort(samples, numberOfSamples, sizeof(double), compareDoubles);
+
+		return;
+	}
+
+	boundaries = (size_t *) checkedMalloc((numberOfChunks + 1) * sizeof(size_t), __FILE__, __LINE__);
+	tasks = (SortTask *) checkedMalloc(numberOfChunks * sizeof(SortTask), __FILE__, __LINE__);
+	threads = (pthread_t *) checkedMalloc(numberOfChunks * sizeof(pthread_t), __FILE__, __LINE__);
+	scratch = (double *) checkedMalloc(numberOfSamples * sizeof(double), __FILE__, __LINE__);
+	source = samples;
+	destination = scratch;
+
+	for (size_t i = 0; i <= numberOfChunks; i++)
+	{
+		boundaries[i] = (numberOfSamples * i) / numberOfChunks;
+	}
+
+	for (size_t i = 0; i < numberOfChunks; i++)
+	{
+		tasks[i] = (SortTask){ .samples = samples, .scratch = scratch, .begin = boundaries[i], .middle = boundaries[i + 1], .end = boundaries[i + 1] };
+	}
+
+	runSortTasks(sortChunk, tasks, threads, numberOfChunks);
+
+	/*
+	 *	Merge passes: each pass halves the number of sorted runs, alternating between the two buffers.
+	 */
+	for (size_t width = 1; width < numberOfChunks; width *= 2)
+	{
+		size_t		numberOfTasks = 0;
+		double *	swap;
+
+		for (size_t i = 0; i < numberOfChunks; i += 2 * width)
+		{
+			size_t	middle = (i + width < numberOfChunks) ? i + width : numberOfChunks;
+			size_t	end = (i + 2 * width < numberOfChunks) ? i + 2 * width : numberOfChunks;
+
+			tasks[numberOfTasks++] = (SortTask){ .samples = source, .scratch = destination, .begin = boundaries[i], .middle = boundaries[middle], .end = boundaries[end] };
+		}
+
+		runSortTasks(mergeChunks, tasks, threads, numberOfTasks);
+
+		swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	/*
+	 *	After an odd number of passes, the sorted samples are in the scratch buffer.
+	 */
+	if (source != samples)
+	{
+		memcpy(samples, source, numberOfSamples * sizeof(double));
+	}
+
+	free(scratch);
+	free(boundaries);
+	free(tasks);
+	free(threads);
+
+	return;
+}
+
+double
+calculateWassersteinDistance(
+	const double *	sortedSamplesA,
+	size_t		numberOfSamplesA,
+	const double *	sortedSamplesB,
+	size_t		numberOfSamplesB)
+{
+	double		distance = 0.0;
+	size_t		i = 0;
+	size_t		j = 0;
+	uint64_t	previousStep = 0;
+
+	/*
+	 *	The quantile functions are step functions with steps at multiples of 1 / numberOfSamplesA
+	 *	and 1 / numberOfSamplesB. Positions are tracked as integer multiples of
+	 *	1 / (numberOfSamplesA * numberOfSamplesB), so that coinciding steps compare exactly.
+	 */
+	while ((i < numberOfSamplesA) && (j < numberOfSamplesB))
+	{
+		uint64_t	nextStepA = (uint64_t)(i + 1) * numberOfSamplesB;
+		uint64_t	nextStepB = (uint64_t)(j + 1) * numberOfSamplesA;
+		uint64_t	nextStep = (nextStepA < nextStepB) ? nextStepA : nextStepB;
+
+		distance += (double)(nextStep - previousStep) * fabs(sortedSamplesA[i] - sortedSamplesB[j]);
+		previousStep = nextStep;
+
+		if (nextStepA == nextStep)
+		{
+			i++;
+		}
+
+		if (nextStepB == nextStep)
+		{
+			j++;
+		}
+	}
+
+	return distance / ((double) numberOfSamplesA * (double) numberOfSamplesB);
+}
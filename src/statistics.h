@@ -0,0 +1,72 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Read samples stored as raw native-endian binary doubles, without a header.
+ *
+ *	@param	path			: Path to the samples file.
+ *	@param	pointerToSamples	: Pointer to store the allocated samples array. The caller frees it.
+ *	@param	numberOfSamples		: Pointer to store the number of samples.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	readBinaryDoubleSamples(
+					const char *	path,
+					double **	pointerToSamples,
+					size_t *	numberOfSamples);
+
+/**
+ *	@brief	Sort samples in ascending order, using several threads.
+ *
+ *	Each thread sorts one contiguous chunk, and the sorted chunks are then merged pairwise, with
+ *	the merges of each pass running in parallel.
+ *
+ *	@param	samples			: The samples to sort in place.
+ *	@param	numberOfSamples		: Number of samples.
+ *	@param	numberOfThreads		: Number of threads to use.
+ */
+void	sortDoubleSamplesInParallel(
+		double *	samples,
+		size_t		numberOfSamples,
+		int		numberOfThreads);
+
+/**
+ *	@brief	Calculate the Wasserstein-1 distance between two empirical distributions.
+ *
+ *	This is the integral over u in [0, 1] of the absolute difference of the two quantile functions,
+ *	computed exactly in a single merge-like pass over both sorted sample sets.
+ *
+ *	@param	sortedSamplesA		: First sample set, sorted in ascending order.
+ *	@param	numberOfSamplesA	: Size of the first sample set.
+ *	@param	sortedSamplesB		: Second sample set, sorted in ascending order.
+ *	@param	numberOfSamplesB	: Size of the second sample set.
+ *	@return				: The Wasserstein-1 distance.
+ */
+double	calculateWassersteinDistance(
+		const double *	sortedSamplesA,
+		size_t		numberOfSamplesA,
+		const double *	sortedSamplesB,
+		size_t		numberOfSamplesB);
@@ -0,0 +1,694 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel.h"
+#include "specializedKernels.h"
+#include "streamingPipeline.h"
+
+
+enum
+{
+	kStreamingPipelineSlotsPerThread		= 4,
+	kStreamingPipelineMaxCharsPerId			= 256,
+	kStreamingPipelineMaxCharsPerError		= 256,
+	kStreamingPipelineMaxCharsPerResult		= 1024,
+};
+
+typedef struct
+{
+	uint64_t		sequenceNumber;
+	size_t			numberOfIterations;
+	char			id[kStreamingPipelineMaxCharsPerId];
+	char			error[kStreamingPipelineMaxCharsPerError];
+	CommandLineArguments	arguments;
+} StreamingScenario;
+
+typedef struct
+{
+	bool	isReady;
+	char	line[kStreamingPipelineMaxCharsPerResult];
+} StreamingResult;
+
+typedef struct
+{
+	pthread_mutex_t		mutex;
+
+	/*
+	 *	Parser to workers: a bounded FIFO of scenarios.
+	 */
+	pthread_cond_t		scenarioAvailable;
+	pthread_cond_t		scenarioSlotAvailable;
+	StreamingScenario *	scenarios;
+	size_t			scenarioHead;
+	size_t			numberOfQueuedScenarios;
+	bool			isInputDone;
+	uint64_t		numberOfScenarios;
+
+	/*
+	 *	Workers to writer: a reorder window, indexed by sequence number modulo its capacity. A
+	 *	worker may only publish results within the window starting at `nextSequenceNumberToWrite`.
+	 */
+	pthread_cond_t		resultReady;
+	pthread_cond_t		resultWindowAdvanced;
+	StreamingResult *	results;
+	uint64_t		nextSequenceNumberToWrite;
+
+	size_t			capacity;
+} StreamingPipeline;
+
+/**
+ *	@brief	Skip JSON whitespace.
+ *
+ *	@param	cursor	: Current position.
+ *	@return		: First non-whitespace position.
+ */
+static const char *
+skipWhitespace(const char *  cursor)
+{
+	while ((*cursor != '\0') && isspace((unsigned char) *cursor))
+	{
+		cursor++;
+	}
+
+	return cursor;
+}
+
+/**
+ *	@brief	Scan a JSON value (string, number or literal) without nested structure.
+ *
+ *	@param	cursor		: Position of the first character of the value.
+ *	@param	raw		: Buffer for the raw JSON text of the value.
+ *	@param	text		: Buffer for the value's text, unquoted if it is a string.
+ *	@param	size		: Size of both buffers.
+ *	@return			: Position after the value, or `NULL` if malformed or too long.
+ */
+static const char *
+scanValue(
+	const char *	cursor,
+	char *		raw,
+	char *		text,
+	size_t		size)
+{
+	const char *	start = cursor;
+	size_t		length = 0;
+
+	if (*cursor == '"')
+	{
+		cursor++;
+
+		while (*cursor != '"')
+		{
+			if ((*cursor == '\0') || (length + 1 >= size))
+			{
+				return NULL;
+			}
+
+			if (*cursor == '\\')
+			{
+				cursor++;
+
+				if (*cursor == '\0')
+				{
+					return NULL;
+				}
+			}
+
+			text[length++] = *cursor++;
+		}
+
+		cursor++;
+	}
+	else
+	{
+		while ((*cursor != '\0') && (*cursor != ',') && (*cursor != '}') && !isspace((unsigned char) *cursor))
+		{
+			if (length + 1 >= size)
+			{
+				return NULL;
+			}
+
+			text[length++] = *cursor++;
+		}
+
+		if (length == 0)
+		{
+			return NULL;
+		}
+	}
+
+	text[length] = '\0';
+
+	if ((size_t)(cursor - start) >= size)
+	{
+		return NULL;
+	}
+
+	memcpy(raw, start, cursor - start);
+	raw[cursor - start] = '\0';
+
+	return cursor;
+}
+
+/**
+ *	@brief	Apply one key-value pair of a scenario line to the scenario.
+ *
+ *	@param	scenario	: Pointer to the scenario.
+ *	@param	key		: The key.
+ *	@param	raw		: The raw JSON text of the value.
+ *	@param	text		: The text of the value.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError` with `scenario->error` set.
+ */
+static CommonConstantReturnType
+applyScenarioValue(
+	StreamingScenario *	scenario,
+	const char *		key,
+	const char *		raw,
+	const char *		text)
+{
+	static const struct
+	{
+		const char *		key;
+		InputDistributionIndex	index;
+	} kInputKeys[] =
+	{
+		{ "t", kInputDistributionIndexTotalAnnualContributionToAccount },
+		{ "c", kInputDistributionIndexCompoundedAnnualInterestRate },
+		{ "w", kInputDistributionIndexWithdrawalRate },
+		{ "r", kInputDistributionIndexAssumedTaxRateOnInterest },
+	};
+	const char		kConstantStringUx[] = "Ux";
+	CommandLineArguments *	arguments = &scenario->arguments;
+	char *			end;
+
+	if (strcmp(key, "id") == 0)
+	{
+		if (strlen(raw) >= kStreamingPipelineMaxCharsPerId)
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "\\\"id\\\" is too long");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		memcpy(scenario->id, raw, strlen(raw) + 1);
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	for (size_t i = 0; i < sizeof(kInputKeys) / sizeof(kInputKeys[0]); i++)
+	{
+		if (strcmp(key, kInputKeys[i].key) == 0)
+		{
+			double	value;
+
+			if (strstr(text, kConstantStringUx) != NULL)
+			{
+				snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "value of \\\"%s\\\" is a Ux string, which native Monte Carlo does not support", kInputKeys[i].key);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			value = strtod(text, &end);
+
+			if ((end == text) || (*end != '\0') || !isfinite(value))
+			{
+				snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "value of \\\"%s\\\" is not a number", kInputKeys[i].key);
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			snprintf(arguments->inputVariablesUxStrings[kInputKeys[i].index], kCommonConstantMaxCharsPerLine, "%s", text);
+			arguments->isInputVariableSet[kInputKeys[i].index] = true;
+
+			return kCommonConstantReturnTypeSuccess;
+		}
+	}
+
+	if (strcmp(key, "n") == 0)
+	{
+		int	value;
+
+		if ((parseIntChecked(text, &value) != kCommonConstantReturnTypeSuccess) || (value < 0))
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "\\\"n\\\" must be a non-negative integer");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->numberOfYearsToRetirement = value;
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	if (strcmp(key, "iterations") == 0)
+	{
+		unsigned long long	value = strtoull(text, &end, 10);
+
+		if ((end == text) || (*end != '\0') || (value == 0))
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "\\\"iterations\\\" must be a positive integer");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		scenario->numberOfIterations = (size_t) value;
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	if (strcmp(key, "select") == 0)
+	{
+		int	value;
+
+		if ((parseIntChecked(text, &value) != kCommonConstantReturnTypeSuccess) || (value < 0) || (value >= kOutputDistributionIndexMax))
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "\\\"select\\\" must be in the range [0, %d]", kOutputDistributionIndexMax - 1);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->common.outputSelect = value;
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "unknown key");
+
+	return kCommonConstantReturnTypeError;
+}
+
+/**
+ *	@brief	Parse one NDJSON line, a flat JSON object, into a scenario.
+ *
+ *	@param	line		: The line.
+ *	@param	scenario	: Pointer to the scenario, whose arguments hold the defaults on entry.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError` with `scenario->error` set.
+ */
+static CommonConstantReturnType
+parseScenarioLine(
+	const char *		line,
+	StreamingScenario *	scenario)
+{
+	const char *	cursor = skipWhitespace(line);
+	char		key[kStreamingPipelineMaxCharsPerId];
+	char		raw[kCommonConstantMaxCharsPerLine];
+	char		text[kCommonConstantMaxCharsPerLine];
+
+	if (*cursor++ != '{')
+	{
+		snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "expected a JSON object");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	cursor = skipWhitespace(cursor);
+
+	if (*cursor == '}')
+	{
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	while (true)
+	{
+		if ((*cursor != '"') || ((cursor = scanValue(cursor, raw, key, sizeof(key))) == NULL))
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "malformed key");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = skipWhitespace(cursor);
+
+		if (*cursor++ != ':')
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "expected ':'");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = scanValue(skipWhitespace(cursor), raw, text, sizeof(text));
+
+		if (cursor == NULL)
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "malformed value");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (applyScenarioValue(scenario, key, raw, text) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = skipWhitespace(cursor);
+
+		if (*cursor == '}')
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+
+		if (*cursor++ != ',')
+		{
+			snprintf(scenario->error, kStreamingPipelineMaxCharsPerError, "expected ',' or '}'");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = skipWhitespace(cursor);
+	}
+}
+
+/**
+ *	@brief	Simulate one scenario and serialize its result as one line of JSON.
+ *
+ *	@param	scenario	: Pointer to the scenario.
+ *	@param	seed		: Seed of the run. The scenario's stream index is its sequence number.
+ *	@param	inputVariables	: Per-worker input buffers.
+ *	@param	capacity	: Pointer to the capacity (in years) of `inputVariables`, updated if they grow.
+ *	@param	line		: Buffer for the serialized result.
+ */
+static void
+simulateScenario(
+	StreamingScenario *	scenario,
+	uint64_t		seed,
+	double *		inputVariables[kInputDistributionIndexMax],
+	size_t *		capacity,
+	char *			line)
+{
+	CommandLineArguments *	arguments = &scenario->arguments;
+	size_t			numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+	double			outputDistributions[kOutputDistributionIndexMax];
+	double			mean[kOutputDistributionIndexMax] = {0};
+	double			sumOfSquaredDeviations[kOutputDistributionIndexMax] = {0};
+	OutputDistributionIndex	outputSelectLowerBound;
+	OutputDistributionIndex	outputSelectUpperBound;
+	CalculateOutputFunction	calculateOutputFunction;
+	SamplingStream		stream;
+	int			length;
+
+	if (scenario->error[0] != '\0')
+	{
+		snprintf(line, kStreamingPipelineMaxCharsPerResult, "{\"line\":%" PRIu64 ",\"error\":\"%s\"}\n", scenario->sequenceNumber + 1, scenario->error);
+
+		return;
+	}
+
+	if (numberOfYearsToRetirement > *capacity)
+	{
+		for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+		{
+			free(inputVariables[i]);
+			inputVariables[i] = (double *) checkedMalloc(numberOfYearsToRetirement * sizeof(double), __FILE__, __LINE__);
+		}
+
+		*capacity = numberOfYearsToRetirement;
+	}
+
+	initSamplingStream(&stream, seed, scenario->sequenceNumber);
+	calculateOutputFunction = selectCalculateOutputFunction(arguments, numberOfYearsToRetirement);
+	determineIndexRangeOfSelectedOutputs(arguments, &outputSelectLowerBound, &outputSelectUpperBound);
+
+	/*
+	 *	Welford's online algorithm, so that no samples need to be kept.
+	 */
+	for (size_t i = 0; i < scenario->numberOfIterations; i++)
+	{
+		setInputVariablesFromStream(arguments, &stream, inputVariables);
+		calculateOutputFunction(arguments, numberOfYearsToRetirement, inputVariables, outputDistributions);
+
+		for (OutputDistributionIndex j = outputSelectLowerBound; j < outputSelectUpperBound; j++)
+		{
+			double	delta = outputDistributions[j] - mean[j];
+
+			mean[j] += delta / (double)(i + 1);
+			sumOfSquaredDeviations[j] += delta * (outputDistributions[j] - mean[j]);
+		}
+	}
+
+	length = snprintf(
+			line,
+			kStreamingPipelineMaxCharsPerResult,
+			"{\"line\":%" PRIu64 "%s%s,\"iterations\":%zu",
+			scenario->sequenceNumber + 1,
+			(scenario->id[0] != '\0') ? ",\"id\":" : "",
+			scenario->id,
+			scenario->numberOfIterations);
+
+	for (OutputDistributionIndex j = outputSelectLowerBound; j < outputSelectUpperBound; j++)
+	{
+		double	variance = (scenario->numberOfIterations > 1) ? sumOfSquaredDeviations[j] / (double)(scenario->numberOfIterations - 1) : 0.0;
+
+		length += snprintf(
+				line + length,
+				kStreamingPipelineMaxCharsPerResult - length,
+				",\"%s\":{\"mean\":%.17g,\"standardDeviation\":%.17g}",
+				kOutputVariableNames[j],
+				mean[j],
+				sqrt(variance));
+	}
+
+	snprintf(line + length, kStreamingPipelineMaxCharsPerResult - length, "}\n");
+
+	return;
+}
+
+static void *
+runStreamingWorker(void *  argument)
+{
+	StreamingPipeline *	pipeline = (StreamingPipeline *) argument;
+	StreamingScenario *	scenario = (StreamingScenario *) checkedMalloc(sizeof(StreamingScenario), __FILE__, __LINE__);
+	double *		inputVariables[kInputDistributionIndexMax] = {NULL};
+	size_t			capacity = 0;
+	char			line[kStreamingPipelineMaxCharsPerResult];
+
+	while (true)
+	{
+		StreamingResult *	result;
+		uint64_t		seed;
+
+		pthread_mutex_lock(&pipeline->mutex);
+
+		while ((pipeline->numberOfQueuedScenarios == 0) && !pipeline->isInputDone)
+		{
+			pthread_cond_wait(&pipeline->scenarioAvailable, &pipeline->mutex);
+		}
+
+		if (pipeline->numberOfQueuedScenarios == 0)
+		{
+			pthread_mutex_unlock(&pipeline->mutex);
+			break;
+		}
+
+		memcpy(scenario, &pipeline->scenarios[pipeline->scenarioHead], sizeof(StreamingScenario));
+		pipeline->scenarioHead = (pipeline->scenarioHead + 1) % pipeline->capacity;
+		pipeline->numberOfQueuedScenarios--;
+		seed = scenario->arguments.seed;
+		pthread_cond_signal(&pipeline->scenarioSlotAvailable);
+		pthread_mutex_unlock(&pipeline->mutex);
+
+		simulateScenario(scenario, seed, inputVariables, &capacity, line);
+
+		pthread_mutex_lock(&pipeline->mutex);
+
+		while (scenario->sequenceNumber >= pipeline->nextSequenceNumberToWrite + pipeline->capacity)
+		{
+			pthread_cond_wait(&pipeline->resultWindowAdvanced, &pipeline->mutex);
+		}
+
+		result = &pipeline->results[scenario->sequenceNumber % pipeline->capacity];
+		memcpy(result->line, line, sizeof(line));
+		result->isReady = true;
+		pthread_cond_signal(&pipeline->resultReady);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+
+	for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		free(inputVariables[i]);
+	}
+
+	free(scenario);
+
+	return NULL;
+}
+
+static void *
+runStreamingWriter(void *  argument)
+{
+	StreamingPipeline *	pipeline = (StreamingPipeline *) argument;
+	char			line[kStreamingPipelineMaxCharsPerResult];
+
+	pthread_mutex_lock(&pipeline->mutex);
+
+	while (true)
+	{
+		StreamingResult *	result = &pipeline->results[pipeline->nextSequenceNumberToWrite % pipeline->capacity];
+
+		if (pipeline->isInputDone && (pipeline->nextSequenceNumberToWrite == pipeline->numberOfScenarios))
+		{
+			break;
+		}
+
+		if (!result->isReady)
+		{
+			pthread_cond_wait(&pipeline->resultReady, &pipeline->mutex);
+			continue;
+		}
+
+		memcpy(line, result->line, sizeof(line));
+		result->isReady = false;
+		pipeline->nextSequenceNumberToWrite++;
+		pthread_cond_broadcast(&pipeline->resultWindowAdvanced);
+
+		/*
+		 *	Write without holding the lock, so that workers can keep publishing. Flush once the
+		 *	writer has caught up, so that results are not held back while waiting for input.
+		 */
+		pthread_mutex_unlock(&pipeline->mutex);
+		fputs(line, stdout);
+		pthread_mutex_lock(&pipeline->mutex);
+
+		if (!pipeline->results[pipeline->nextSequenceNumberToWrite % pipeline->capacity].isReady)
+		{
+			pthread_mutex_unlock(&pipeline->mutex);
+			fflush(stdout);
+			pthread_mutex_lock(&pipeline->mutex);
+		}
+	}
+
+	pthread_mutex_unlock(&pipeline->mutex);
+	fflush(stdout);
+
+	return NULL;
+}
+
+CommonConstantReturnType
+runStreamingPipelineMode(CommandLineArguments *  arguments)
+{
+	StreamingPipeline	pipeline;
+	pthread_t *		workers;
+	pthread_t		writer;
+	char *			line = NULL;
+	size_t			lineCapacity = 0;
+	int			numberOfThreads = arguments->numberOfThreads;
+
+	memset(&pipeline, 0, sizeof(pipeline));
+	pthread_mutex_init(&pipeline.mutex, NULL);
+	pthread_cond_init(&pipeline.scenarioAvailable, NULL);
+	pthread_cond_init(&pipeline.scenarioSlotAvailable, NULL);
+	pthread_cond_init(&pipeline.resultReady, NULL);
+	pthread_cond_init(&pipeline.resultWindowAdvanced, NULL);
+	pipeline.capacity = kStreamingPipelineSlotsPerThread * numberOfThreads;
+	pipeline.scenarios = (StreamingScenario *) checkedMalloc(pipeline.capacity * sizeof(StreamingScenario), __FILE__, __LINE__);
+	pipeline.results = (StreamingResult *) checkedMalloc(pipeline.capacity * sizeof(StreamingResult), __FILE__, __LINE__);
+	workers = (pthread_t *) checkedMalloc(numberOfThreads * sizeof(pthread_t), __FILE__, __LINE__);
+
+	for (size_t i = 0; i < pipeline.capacity; i++)
+	{
+		pipeline.results[i].isReady = false;
+	}
+
+	for (int i = 0; i < numberOfThreads; i++)
+	{
+		if (pthread_create(&workers[i], NULL, runStreamingWorker, &pipeline) != 0)
+		{
+			fprintf(stderr, "Error: Could not create worker thread.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (pthread_create(&writer, NULL, runStreamingWriter, &pipeline) != 0)
+	{
+		fprintf(stderr, "Error: Could not create writer thread.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/*
+	 *	Parser stage, on the calling thread.
+	 */
+	while (getline(&line, &lineCapacity, stdin) != -1)
+	{
+		StreamingScenario *	scenario;
+
+		if (*skipWhitespace(line) == '\0')
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&pipeline.mutex);
+
+		while (pipeline.numberOfQueuedScenarios == pipeline.capacity)
+		{
+			pthread_cond_wait(&pipeline.scenarioSlotAvailable, &pipeline.mutex);
+		}
+
+		scenario = &pipeline.scenarios[(pipeline.scenarioHead + pipeline.numberOfQueuedScenarios) % pipeline.capacity];
+		pthread_mutex_unlock(&pipeline.mutex);
+
+		/*
+		 *	The slot is not visible to workers until it is counted in `numberOfQueuedScenarios`,
+		 *	so it can be filled without holding the lock.
+		 */
+		memcpy(&scenario->arguments, arguments, sizeof(CommandLineArguments));
+		scenario->sequenceNumber = pipeline.numberOfScenarios;
+		scenario->numberOfIterations = arguments->common.numberOfMonteCarloIterations;
+		scenario->id[0] = '\0';
+		scenario->error[0] = '\0';
+		parseScenarioLine(line, scenario);
+
+		pthread_mutex_lock(&pipeline.mutex);
+		pipeline.numberOfQueuedScenarios++;
+		pipeline.numberOfScenarios++;
+		pthread_cond_signal(&pipeline.scenarioAvailable);
+		pthread_mutex_unlock(&pipeline.mutex);
+	}
+
+	pthread_mutex_lock(&pipeline.mutex);
+	pipeline.isInputDone = true;
+	pthread_cond_broadcast(&pipeline.scenarioAvailable);
+	pthread_cond_broadcast(&pipeline.resultReady);
+	pthread_mutex_unlock(&pipeline.mutex);
+
+	for (int i = 0; i < numberOfThreads; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+
+	pthread_join(writer, NULL);
+
+	free(line);
+	free(workers);
+	free(pipeline.scenarios);
+	free(pipeline.results);
+	pthread_mutex_destroy(&pipeline.mutex);
+	pthread_cond_destroy(&pipeline.scenarioAvailable);
+	pthread_cond_destroy(&pipeline.scenarioSlotAvailable);
+	pthread_cond_destroy(&pipeline.resultReady);
+	pthread_cond_destroy(&pipeline.resultWindowAdvanced);
+
+	return kCommonConstantReturnTypeSuccess;
+}
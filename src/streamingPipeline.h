@@ -0,0 +1,40 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "utilities.h"
+
+
+/**
+ *	@brief	Run the streaming mode: scenarios from NDJSON on stdin, results as NDJSON on stdout.
+ *
+ *	Each line of stdin is a JSON object whose keys override the command-line arguments for one
+ *	scenario: `n`, `c`, `t`, `r`, `w` (as the command-line options), `iterations` (as `-M`),
+ *	`select` (as `-S`), and `id` (echoed in the result). The calling thread parses lines, a pool
+ *	of `arguments->numberOfThreads` workers simulates scenarios, and a writer thread prints the
+ *	results in input order. The stages are connected by bounded queues so that they overlap.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct with the defaults of all scenarios.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runStreamingPipelineMode(CommandLineArguments *  arguments);
@@ -0,0 +1,71 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+
+
+/**
+ *	Number of iterations between two checks of the clock in time-budgeted execution.
+ */
+enum
+{
+	kTimeBudgetChunkSize = 1024,
+};
+
+typedef struct
+{
+	double	deadline;
+	double	chunkStartTime;
+} TimeBudget;
+
+/**
+ *	@brief	Get the time of the monotonic clock.
+ *
+ *	@return		: Time in seconds since an arbitrary, fixed point in the past.
+ */
+double	getMonotonicTimeInSeconds(void);
+
+/**
+ *	@brief	Start a time budget.
+ *
+ *	@param	timeBudget			: Pointer to the time budget to start.
+ *	@param	startTime			: Monotonic time from which the budget counts, in seconds.
+ *	@param	budgetInMilliseconds		: The budget, in milliseconds.
+ */
+void	startTimeBudget(
+		TimeBudget *	timeBudget,
+		double		startTime,
+		double		budgetInMilliseconds);
+
+/**
+ *	@brief	Check, at the end of a chunk, whether the next chunk fits in the time budget.
+ *
+ *	The next chunk is predicted to take as long as the one that just finished, which absorbs
+ *	changes of machine load over the run.
+ *
+ *	@param	timeBudget	: Pointer to the time budget.
+ *	@return			: `true` if the next chunk is predicted to finish before the deadline.
+ */
+bool	timeBudgetAllowsNextChunk(TimeBudget *  timeBudget);
@@ -30,18 +30,78 @@
 #include <unistd.h>
 #include <limits.h>
 #include <uxhw.h>
+#include "correlation.h"
+#include "inputBootstrap.h"
+#include "parallelMonteCarlo.h"
+#include "scenarioComparison.h"
 #include "utilities.h"
 
 
+const double		kDefaultInputDistributionMin[kInputDistributionIndexMax] =
+			{
+				kDefaultInputDistributionConstantAnnualContributionMin,
+				kDefaultInputDistributionConstantAnnualInterestRateMin,
+				kDefaultInputDistributionConstantWithdrawalRateMin,
+				kDefaultInputDistributionConstantTaxRateInterestMin
+			};
+const double		kDefaultInputDistributionMax[kInputDistributionIndexMax] =
+			{
+				kDefaultInputDistributionConstantAnnualContributionMax,
+				kDefaultInputDistributionConstantAnnualInterestRateMax,
+				kDefaultInputDistributionConstantWithdrawalRateMax,
+				kDefaultInputDistributionConstantTaxRateInterestMax
+			};
+
+const char *		kOutputVariableNames[kOutputDistributionIndexMax] =
+			{
+				"futureValueTaxed",
+				"futureValueTaxFreeWithWithdrawalTax"
+			};
+
+static const char *	kOutputVariableDescriptionPrefixes[kOutputDistributionIndexMax] =
+			{
+				"Future value, for yearly taxable payments",
+				"Future value, for yearly tax-free payments and taxed withdrawal-events"
+			};
+
+const char *		kInputCSVHeaders[kInputDistributionIndexMax] =
+			{
+				"total_annual_contribution",
+				"compounded_annual_interest_percentage",
+				"withdrawal_rate_percentage",
+				"assumed_tax_rate_on_interest_percentage"
+			};
+
+/**
+ *	@brief	Draw from Uniform(min, max) via a UxHw call, or from a sampling stream if one is given.
+ *
+ *	@param	stream	: Sampling stream, or `NULL` to use UxHw calls.
+ *	@param	min	: Lower bound.
+ *	@param	max	: Upper bound.
+ *	@return		: The distributional value (UxHw) or sample (stream).
+ */
+static double
+drawUniform(SamplingStream *  stream, double  min, double  max)
+{
+	if (stream != NULL)
+	{
+		return samplingStreamUniform(stream, min, max);
+	}
+
+	return UxHwDoubleUniformDist(min, max);
+}
+
 /**
  *	@brief	Return the default distributional value for the compounded annual interest rate.
  *
+ *	@param	stream	: Sampling stream, or `NULL` to use UxHw calls.
  *	@return	: The distributional value for the compounded annual interest rate.
  */
 static double
-getDefaultCompoundedAnnualInterestRate()
+getDefaultCompoundedAnnualInterestRate(SamplingStream *  stream)
 {
-	return UxHwDoubleUniformDist(
+	return drawUniform(
+		stream,
 		kDefaultInputDistributionConstantAnnualInterestRateMin,
 		kDefaultInputDistributionConstantAnnualInterestRateMax);
 }
@@ -49,12 +109,14 @@ getDefaultCompoundedAnnualInterestRate()
 /**
  *	@brief	Return the default distributional value for the total annual contribution to account.
  *
+ *	@param	stream	: Sampling stream, or `NULL` to use UxHw calls.
  *	@return	: The distributional value for the total annual contribution to account.
  */
 static double
-getDefaultTotalAnnualContributionToAccount()
+getDefaultTotalAnnualContributionToAccount(SamplingStream *  stream)
 {
-	return UxHwDoubleUniformDist(
+	return drawUniform(
+		stream,
 		kDefaultInputDistributionConstantAnnualContributionMin,
 		kDefaultInputDistributionConstantAnnualContributionMax);
 }
@@ -62,12 +124,14 @@ getDefaultTotalAnnualContributionToAccount()
 /**
  *	@brief	Return the default distributional value for the assumed tax rate on interest.
  *
+ *	@param	stream	: Sampling stream, or `NULL` to use UxHw calls.
  *	@return	: The distributional value for the assumed tax rate on interest.
  */
 static double
-getDefaultAssumedTaxRateOnInterest()
+getDefaultAssumedTaxRateOnInterest(SamplingStream *  stream)
 {
-	return UxHwDoubleUniformDist(
+	return drawUniform(
+		stream,
 		kDefaultInputDistributionConstantTaxRateInterestMin,
 		kDefaultInputDistributionConstantTaxRateInterestMax);
 }
@@ -75,21 +139,158 @@ getDefaultAssumedTaxRateOnInterest()
 /**
  *	@brief	Return the default distributional value for withdrawal rate.
  *
+ *	@param	stream	: Sampling stream, or `NULL` to use UxHw calls.
  *	@return	: The distributional value for the withdrawal rate.
  */
 static double
-getDefaultWithdrawalRate()
+getDefaultWithdrawalRate(SamplingStream *  stream)
 {
-	return UxHwDoubleUniformDist(
+	return drawUniform(
+		stream,
 		kDefaultInputDistributionConstantWithdrawalRateMin,
 		kDefaultInputDistributionConstantWithdrawalRateMax);
 }
 
+/**
+ *	@brief	Set the input variables of several consecutive paths with the Gaussian-copula sampler of `arguments->inputCorrelation`.
+ *
+ *	Standard normal draws are only generated for the inputs that are not set from the command
+ *	line, path after path, so that a batch of paths draws the same samples as the same paths one
+ *	at a time. They are correlated in place, all paths at once, via the precomputed Cholesky
+ *	factor and AR(1) filters, and finally mapped to the default uniform marginals. Inputs set
+ *	from the command line keep their values, as in `setInputVariables()`.
+ *
+ *	@param	arguments	: Pointer to command-line arguments struct.
+ *	@param	stream		: Sampling stream, or `NULL` to use UxHw calls.
+ *	@param	numberOfPaths	: Number of paths.
+ *	@param	inputVariables	: The input variables to be set, holding the years of each path in turn.
+ */
+static void
+setCorrelatedInputVariables(
+	CommandLineArguments *	arguments,
+	SamplingStream *	stream,
+	size_t			numberOfPaths,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	size_t		numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
+	size_t		numberOfElements = numberOfPaths * numberOfYearsToRetirement;
+	unsigned	freeInputs = 0;
+
+	/*
+	 *	With a sampling stream or in Monte Carlo mode, values are plain numbers, so inputs set
+	 *	from the command line are parsed once, and the normal CDF is interpolated from a table.
+	 *	Otherwise, they are distributions, which are handled as in `setInputVariablesFromStream()`.
+	 */
+	bool		isSampleBased = (stream != NULL) || arguments->common.isMonteCarloMode;
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		if (!arguments->isInputVariableSet[j])
+		{
+			freeInputs |= 1u << j;
+		}
+	}
+
+	for (size_t path = 0; path < numberOfPaths; path++)
+	{
+		for (int j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			double *	pathInputVariable = &inputVariables[j][path * numberOfYearsToRetirement];
+
+			if (!((freeInputs >> j) & 1u))
+			{
+				continue;
+			}
+
+			if (stream != NULL)
+			{
+				samplingStreamStandardGaussBatch(stream, pathInputVariable, numberOfYearsToRetirement);
+			}
+			else
+			{
+				for (size_t i = 0; i < numberOfYearsToRetirement; i++)
+				{
+					pathInputVariable[i] = UxHwDoubleGaussDist(0.0, 1.0);
+				}
+			}
+		}
+	}
+
+	correlateStandardNormalBatch(&arguments->inputCorrelation, freeInputs, numberOfPaths, numberOfYearsToRetirement, inputVariables);
+
+	for (int j = 0; j < kInputDistributionIndexMax; j++)
+	{
+		if (arguments->isInputVariableSet[j] && isSampleBased)
+		{
+			double	value = 0.0;
+
+			sscanf(arguments->inputVariablesUxStrings[j], "%lf", &value);
+
+			for (size_t i = 0; i < numberOfElements; i++)
+			{
+				inputVariables[j][i] = value;
+			}
+		}
+		else if (arguments->isInputVariableSet[j])
+		{
+			for (size_t i = 0; i < numberOfElements; i++)
+			{
+				sscanf(arguments->inputVariablesUxStrings[j], "%lf", &inputVariables[j][i]);
+			}
+		}
+		else if (isSampleBased)
+		{
+			mapStandardNormalBatchToUniform(
+				inputVariables[j],
+				numberOfElements,
+				kDefaultInputDistributionMin[j],
+				kDefaultInputDistributionMax[j]);
+		}
+		else
+		{
+			for (size_t i = 0; i < numberOfElements; i++)
+			{
+				inputVariables[j][i] = mapStandardNormalToUniform(
+								inputVariables[j][i],
+								kDefaultInputDistributionMin[j],
+								kDefaultInputDistributionMax[j]);
+			}
+		}
+	}
+
+	return;
+}
+
 void
 setInputVariables(
 	CommandLineArguments *	arguments,
 	double *		inputVariables[kInputDistributionIndexMax])
 {
+	setInputVariablesFromStream(arguments, NULL, inputVariables);
+
+	return;
+}
+
+void
+setInputVariablesFromStream(
+	CommandLineArguments *	arguments,
+	SamplingStream *	stream,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	if (arguments->inputBootstrap.isEnabled)
+	{
+		setBootstrappedInputVariables(&arguments->inputBootstrap, arguments->numberOfYearsToRetirement, stream, inputVariables);
+
+		return;
+	}
+
+	if (arguments->inputCorrelation.isEnabled)
+	{
+		setCorrelatedInputVariables(arguments, stream, 1, inputVariables);
+
+		return;
+	}
+
 	for (int i = 0; i < arguments->numberOfYearsToRetirement; i++)
 	{
 		/*
@@ -110,7 +311,7 @@ setInputVariables(
 		}
 		else
 		{
-			inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount][i] = getDefaultTotalAnnualContributionToAccount();
+			inputVariables[kInputDistributionIndexTotalAnnualContributionToAccount][i] = getDefaultTotalAnnualContributionToAccount(stream);
 		}
 
 		if(arguments->isInputVariableSet[kInputDistributionIndexCompoundedAnnualInterestRate])
@@ -119,7 +320,7 @@ setInputVariables(
 		}
 		else
 		{
-			inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate][i] = getDefaultCompoundedAnnualInterestRate();
+			inputVariables[kInputDistributionIndexCompoundedAnnualInterestRate][i] = getDefaultCompoundedAnnualInterestRate(stream);
 		}
 
 		if(arguments->isInputVariableSet[kInputDistributionIndexAssumedTaxRateOnInterest])
@@ -128,7 +329,7 @@ setInputVariables(
 		}
 		else
 		{
-			inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest][i] = getDefaultAssumedTaxRateOnInterest();
+			inputVariables[kInputDistributionIndexAssumedTaxRateOnInterest][i] = getDefaultAssumedTaxRateOnInterest(stream);
 		}
 
 		if(arguments->isInputVariableSet[kInputDistributionIndexWithdrawalRate])
@@ -137,8 +338,37 @@ setInputVariables(
 		}
 		else
 		{
-			inputVariables[kInputDistributionIndexWithdrawalRate][i] = getDefaultWithdrawalRate();
+			inputVariables[kInputDistributionIndexWithdrawalRate][i] = getDefaultWithdrawalRate(stream);
+		}
+	}
+
+	return;
+}
+
+void
+setInputVariablesBatchFromStream(
+	CommandLineArguments *	arguments,
+	SamplingStream *	stream,
+	size_t			numberOfPaths,
+	double *		inputVariables[kInputDistributionIndexMax])
+{
+	if (arguments->inputCorrelation.isEnabled && !arguments->inputBootstrap.isEnabled)
+	{
+		setCorrelatedInputVariables(arguments, stream, numberOfPaths, inputVariables);
+
+		return;
+	}
+
+	for (size_t path = 0; path < numberOfPaths; path++)
+	{
+		double *	pathInputVariables[kInputDistributionIndexMax];
+
+		for (int j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			pathInputVariables[j] = &inputVariables[j][path * arguments->numberOfYearsToRetirement];
 		}
+
+		setInputVariablesFromStream(arguments, stream, pathInputVariables);
 	}
 
 	return;
@@ -177,6 +407,59 @@ determineIndexRangeOfSelectedOutputs(
 	return;
 }
 
+/**
+ *	@brief	Parse a comma-separated list of doubles.
+ *
+ *	@param	string			: The string to parse.
+ *	@param	values			: Array to store the parsed values.
+ *	@param	maxNumberOfValues	: Capacity of `values`.
+ *	@param	numberOfValues		: Pointer to store the number of parsed values.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseCommaSeparatedDoubles(
+	const char *	string,
+	double *	values,
+	size_t		maxNumberOfValues,
+	size_t *	numberOfValues)
+{
+	const char *	cursor = string;
+
+	*numberOfValues = 0;
+
+	while (true)
+	{
+		char *	end;
+
+		if (*numberOfValues == maxNumberOfValues)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		errno = 0;
+		values[*numberOfValues] = strtod(cursor, &end);
+
+		if ((end == cursor) || (errno != 0) || !isfinite(values[*numberOfValues]))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		(*numberOfValues)++;
+
+		if (*end == '\0')
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+
+		if (*end != ',')
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		cursor = end + 1;
+	}
+}
+
 /**
  *	@brief	Set the default values for the command-line arguments.
  *
@@ -207,6 +490,25 @@ setDefaultCommandLineArguments(CommandLineArguments *  arguments)
 	memset(&arguments->common, 0, sizeof(CommonCommandLineArguments));
 
 	arguments->numberOfYearsToRetirement = kDemoFinanceIraDefaultNumberOfYearsToRetirement;
+	arguments->periodsPerYear = kDemoFinanceIraDefaultPeriodsPerYear;
+
+	arguments->numberOfThreads = 0;
+	arguments->threadAffinity.policy = kThreadAffinityPolicyScatter;
+	arguments->seed = kDefaultSamplingSeed;
+	arguments->contributionConfidence = kDefaultContributionConfidence;
+	arguments->progressIntervalInSeconds = kDefaultProgressIntervalInSeconds;
+	arguments->streamOutputChunkSize = kDemoFinanceIraDefaultStreamOutputChunkSize;
+	arguments->checkpointIntervalInSeconds = kDefaultCheckpointIntervalInSeconds;
+	arguments->sampleArchiveQuantum = kDefaultSampleArchiveQuantum;
+
+	memset(&arguments->inputCorrelation, 0, sizeof(InputCorrelation));
+	memset(&arguments->inputBootstrap, 0, sizeof(InputBootstrap));
+	arguments->inputBootstrap.blockLength = 1;
+
+	for (int i = 0; i < kInputDistributionIndexMax; i++)
+	{
+		arguments->inputCorrelation.crossCorrelation[i][i] = 1.0;
+	}
 
 	snprintf(
 		arguments->inputVariablesUxStrings[kInputDistributionIndexCompoundedAnnualInterestRate],
@@ -253,11 +555,49 @@ printUsage(void)
 		"\t[-j, --json] (Print output in JSON format.)\n"
 		"\t[-h, --help] (Display this help message.)\n"
 		"\t[-n, --number-of-years <The number of years to retirement : int in [0, inf)> (Default: %d)]\n"
+		"\t[-m, --periods-per-year <Number of compounding periods and contribution installments per year : int in [1, inf)> (Default: %d)]\n"
 		"\t[-c, --compounded-annual-interest-rate <The compounded annual interest rate expressed as a percentage: double> (Default: Uniform(%"SignaloidParticleModifier".1f, %"SignaloidParticleModifier".1f))]\n"
 		"\t[-t, --total-annual-contribution-to-account <The total annual contribution to the account : double> (Default: Uniform(%"SignaloidParticleModifier".1f, %"SignaloidParticleModifier".1f))]\n"
 		"\t[-r, --assumed-tax-rate-on-interest <The assumed tax rate on interest expressed as a percentage : double> (Default: Uniform(%"SignaloidParticleModifier".1f, %"SignaloidParticleModifier".1f))]\n"
-		"\t[-w, --withdrawal-rate <The withdrawal rate expressed as a percentage : double> (Default: Uniform(%"SignaloidParticleModifier".1f, %"SignaloidParticleModifier".1f))]\n",
+		"\t[-w, --withdrawal-rate <The withdrawal rate expressed as a percentage : double> (Default: Uniform(%"SignaloidParticleModifier".1f, %"SignaloidParticleModifier".1f))]\n"
+		"\t[-a, --autocorrelation <AR(1) coefficient across years : double in (-1, 1), or comma-separated list of one per input in the order t,c,w,r> (Default: 0)]\n"
+		"\t[-C, --input-correlations <Cross-input correlations : comma-separated upper triangle (t-c,t-w,t-r,c-w,c-r,w-r)> (Default: 0)]\n"
+		"\t[-H, --household <Path to household accounts CSV file : str>] (Household mode: Sum of the future values of several accounts with shared market draws.)\n"
+		"\t[-g, --target <Target future value : double>]\n"
+		"\t[-I, --importance-sampling] (Rare-event mode: Estimate P(output < target) with importance sampling. Requires Monte Carlo mode.)\n"
+		"\t[-G, --solve-contribution] (Goal-seek mode: Find the constant annual contribution that reaches the target with the given confidence. Requires Monte Carlo mode.)\n"
+		"\t[-q, --confidence <Probability of reaching the target in goal-seek mode : double in (0, 1)> (Default: %.2lf)]\n"
+		"\t[-N, --stdin-ndjson] (Streaming mode: Read one scenario per line of NDJSON from stdin and write one result per line to stdout.)\n"
+		"\t[-p, --threads <Number of worker threads : int in [1, inf)> (Default: number of online processors)]\n"
+		"\t[-Q, --numa] (NUMA-aware Monte Carlo mode: Run the Monte Carlo iterations on -p pinned threads, each placing its slice of the buffers on its own node.)\n"
+		"\t[-A, --affinity <Pinning of the threads of NUMA-aware mode : none, compact, scatter, or a list of CPUs, e.g., 0,2,4-7> (Default: scatter)]\n"
+		"\t[-L, --huge-pages] (Back the sample buffer of NUMA-aware mode with transparent huge pages.)\n"
+		"\t[-s, --seed <Seed of the sampling streams of multi-threaded modes : uint64> (Default: %" PRIu64 ")]\n"
+		"\t[-R, --reference <Path to reference samples file (raw binary doubles) : str>] (In benchmarking mode, also print the Wasserstein-1 distance of the output samples to the reference.)\n"
+		"\t[-B, --time-budget <Time budget in milliseconds : double in (0, inf)>] (Stop Monte Carlo iterations before the budget runs out. -M is the maximum number of iterations.)\n"
+		"\t[-E, --metrics-file <Path to Prometheus text-format metrics file : str>] (Periodically write progress metrics of Monte Carlo mode to the file.)\n"
+		"\t[-D, --progress] (Periodically print progress metrics of Monte Carlo mode to stderr.)\n"
+		"\t[-P, --progress-interval <Interval between progress reports in seconds : double in (0, inf)> (Default: %.1lf)] (SIGUSR1 triggers an immediate report.)\n"
+		"\t[-F, --fused] (In Monte Carlo mode, draw the inputs of each year and advance the future values in a single pass, without filling the per-year input arrays.)\n"
+		"\t[-O, --stream-output] (Write the samples of Monte Carlo mode to data.out in chunks, in the background, while the simulation runs.)\n"
+		"\t[-K, --chunk-size <Number of samples per chunk of streamed output : int in [1, inf)> (Default: %d)]\n"
+		"\t[-x, --bootstrap] (In Monte Carlo mode, resample the rows of the input CSV file for each year of each path. Rows are weighted by an optional weight column.)\n"
+		"\t[-l, --block-length <Number of consecutive rows per bootstrap block : int in [1, inf)> (Default: 1)]\n"
+		"\t[-U, --moments] (Print the exact mean and standard deviation of the outputs, calculated from the moments of the inputs without sampling.)\n"
+		"\t[-k, --checkpoint <Path to checkpoint file : str>] (Periodically save the progress of Monte Carlo mode to the file, in the background.)\n"
+		"\t[-y, --checkpoint-interval <Interval between checkpoints in seconds : double in (0, inf)> (Default: %.1lf)]\n"
+		"\t[-Y, --resume] (Resume Monte Carlo mode from the checkpoint file, if it exists.)\n"
+		"\t[-z, --archive <Path to sample archive file : str>] (Also write the samples of Monte Carlo mode to a compressed archive of quantized, sorted samples.)\n"
+		"\t[-Z, --archive-precision <Precision of the archived samples : double in (0, inf)> (Default: %.2lf)]\n"
+		"\t[-u, --unpack <Path to sample archive file : str>] (Unpack mode: Print the samples of the archive, in ascending order, one per line.)\n"
+		"\t[-f, --unpack-range <First rank and number of samples : comma-separated pair of int in [0, inf)> (Default: all samples)] (In unpack mode, print only this range of ranks, reading only the blocks that hold it.)\n"
+		"\t[-d, --compare <Overrides of scenario B : comma-separated key=value, keys t, c, r, w, m, S, e.g., t=8000,S=1>] (Comparison mode: Evaluate scenario B on the same sampled inputs as the arguments (scenario A), and report B - A. Requires Monte Carlo mode.)\n"
+		"\t[-V, --control-variate] (Control-variate mode: Estimate the mean and standard deviation of the output with the closed-form future value at the average inputs as a control variate. Requires Monte Carlo mode.)\n"
+		"\t[-e, --decumulation-years <Number of years of retirement : int in [1, inf)>] (Decumulation mode: Withdraw from the account every year of retirement, and report the probability and timing of ruin. Requires Monte Carlo mode.)\n"
+		"\t[-X, --annual-withdrawal <Withdrawal per year of retirement : double in [0, inf)> (Default: %.1lf%% of the balance at retirement)]\n"
+		"\t[-J, --sobol-indices] (Sensitivity mode: Estimate the first-order and total-effect Sobol indices of the inputs for the output, with a Saltelli design of -M base samples. Requires Monte Carlo mode.)\n",
 		kDemoFinanceIraDefaultNumberOfYearsToRetirement,
+		kDemoFinanceIraDefaultPeriodsPerYear,
 		kDefaultInputDistributionConstantAnnualInterestRateMin,
 		kDefaultInputDistributionConstantAnnualInterestRateMax,
 		kDefaultInputDistributionConstantAnnualContributionMin,
@@ -265,7 +605,14 @@ printUsage(void)
 		kDefaultInputDistributionConstantTaxRateInterestMin,
 		kDefaultInputDistributionConstantTaxRateInterestMax,
 		kDefaultInputDistributionConstantWithdrawalRateMin,
-		kDefaultInputDistributionConstantWithdrawalRateMax);
+		kDefaultInputDistributionConstantWithdrawalRateMax,
+		kDefaultContributionConfidence,
+		kDefaultSamplingSeed,
+		kDefaultProgressIntervalInSeconds,
+		kDemoFinanceIraDefaultStreamOutputChunkSize,
+		kDefaultCheckpointIntervalInSeconds,
+		kDefaultSampleArchiveQuantum,
+		kDefaultDecumulationWithdrawalPercentage);
 
 	fprintf(stderr, "\n");
 
@@ -276,10 +623,34 @@ CommonConstantReturnType
 getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  arguments)
 {
 	const char *	numberOfYearsToRetirementArg = NULL;
+	const char *	periodsPerYearArg = NULL;
 	const char *	compoundedAnnualInterestRateArg = NULL;
 	const char *	totalAnnualContributionToAccountArg = NULL;
 	const char *	assumedTaxRateOnInterestArg = NULL;
 	const char *	withdrawalRateArg = NULL;
+	const char *	autocorrelationArg = NULL;
+	const char *	inputCorrelationsArg = NULL;
+	const char *	householdArg = NULL;
+	const char *	targetArg = NULL;
+	const char *	confidenceArg = NULL;
+	const char *	threadsArg = NULL;
+	const char *	affinityArg = NULL;
+	const char *	seedArg = NULL;
+	const char *	referenceArg = NULL;
+	const char *	timeBudgetArg = NULL;
+	const char *	metricsFileArg = NULL;
+	const char *	progressIntervalArg = NULL;
+	const char *	chunkSizeArg = NULL;
+	const char *	blockLengthArg = NULL;
+	const char *	checkpointArg = NULL;
+	const char *	checkpointIntervalArg = NULL;
+	const char *	compareArg = NULL;
+	const char *	sampleArchiveArg = NULL;
+	const char *	sampleArchivePrecisionArg = NULL;
+	const char *	unpackArg = NULL;
+	const char *	unpackRangeArg = NULL;
+	const char *	decumulationYearsArg = NULL;
+	const char *	annualWithdrawalArg = NULL;
 	bool 		distributionalArgumentGiven = false;
 	const char	kConstantStringUx[] = "Ux";
 
@@ -298,10 +669,47 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 	DemoOption	options[] =
 	{
 		{ .opt = "n", .optAlternative = "number-of-years",			.hasArg = true, .foundArg = &numberOfYearsToRetirementArg,		.foundOpt = NULL },
+		{ .opt = "m", .optAlternative = "periods-per-year",			.hasArg = true, .foundArg = &periodsPerYearArg,				.foundOpt = NULL },
 		{ .opt = "c", .optAlternative = "compounded-annual-interest-rate",	.hasArg = true, .foundArg = &compoundedAnnualInterestRateArg,		.foundOpt = NULL },
 		{ .opt = "t", .optAlternative = "total-annual-contribution-to-account",	.hasArg = true, .foundArg = &totalAnnualContributionToAccountArg,	.foundOpt = NULL },
 		{ .opt = "r", .optAlternative = "assumed-tax-rate-on-interest",		.hasArg = true, .foundArg = &assumedTaxRateOnInterestArg,		.foundOpt = NULL },
 		{ .opt = "w", .optAlternative = "withdrawal-rate",			.hasArg = true, .foundArg = &withdrawalRateArg,				.foundOpt = NULL },
+		{ .opt = "a", .optAlternative = "autocorrelation",			.hasArg = true, .foundArg = &autocorrelationArg,			.foundOpt = NULL },
+		{ .opt = "C", .optAlternative = "input-correlations",			.hasArg = true, .foundArg = &inputCorrelationsArg,			.foundOpt = NULL },
+		{ .opt = "H", .optAlternative = "household",				.hasArg = true, .foundArg = &householdArg,				.foundOpt = NULL },
+		{ .opt = "g", .optAlternative = "target",				.hasArg = true, .foundArg = &targetArg,					.foundOpt = NULL },
+		{ .opt = "I", .optAlternative = "importance-sampling",			.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isImportanceSamplingEnabled },
+		{ .opt = "G", .optAlternative = "solve-contribution",			.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isContributionSolverEnabled },
+		{ .opt = "q", .optAlternative = "confidence",				.hasArg = true, .foundArg = &confidenceArg,				.foundOpt = NULL },
+		{ .opt = "N", .optAlternative = "stdin-ndjson",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isNdjsonModeEnabled },
+		{ .opt = "p", .optAlternative = "threads",				.hasArg = true, .foundArg = &threadsArg,				.foundOpt = NULL },
+		{ .opt = "Q", .optAlternative = "numa",					.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isParallelMonteCarloEnabled },
+		{ .opt = "A", .optAlternative = "affinity",				.hasArg = true, .foundArg = &affinityArg,				.foundOpt = NULL },
+		{ .opt = "L", .optAlternative = "huge-pages",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isHugePagesEnabled },
+		{ .opt = "s", .optAlternative = "seed",					.hasArg = true, .foundArg = &seedArg,					.foundOpt = NULL },
+		{ .opt = "R", .optAlternative = "reference",				.hasArg = true, .foundArg = &referenceArg,				.foundOpt = NULL },
+		{ .opt = "B", .optAlternative = "time-budget",				.hasArg = true, .foundArg = &timeBudgetArg,				.foundOpt = NULL },
+		{ .opt = "E", .optAlternative = "metrics-file",				.hasArg = true, .foundArg = &metricsFileArg,				.foundOpt = NULL },
+		{ .opt = "D", .optAlternative = "progress",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isProgressToStderrEnabled },
+		{ .opt = "P", .optAlternative = "progress-interval",			.hasArg = true, .foundArg = &progressIntervalArg,			.foundOpt = NULL },
+		{ .opt = "F", .optAlternative = "fused",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isFusedKernelEnabled },
+		{ .opt = "O", .optAlternative = "stream-output",			.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isStreamOutputEnabled },
+		{ .opt = "K", .optAlternative = "chunk-size",				.hasArg = true, .foundArg = &chunkSizeArg,				.foundOpt = NULL },
+		{ .opt = "x", .optAlternative = "bootstrap",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->inputBootstrap.isEnabled },
+		{ .opt = "l", .optAlternative = "block-length",				.hasArg = true, .foundArg = &blockLengthArg,				.foundOpt = NULL },
+		{ .opt = "U", .optAlternative = "moments",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isMomentsModeEnabled },
+		{ .opt = "k", .optAlternative = "checkpoint",				.hasArg = true, .foundArg = &checkpointArg,				.foundOpt = NULL },
+		{ .opt = "y", .optAlternative = "checkpoint-interval",			.hasArg = true, .foundArg = &checkpointIntervalArg,			.foundOpt = NULL },
+		{ .opt = "Y", .optAlternative = "resume",				.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isResumeEnabled },
+		{ .opt = "d", .optAlternative = "compare",				.hasArg = true, .foundArg = &compareArg,				.foundOpt = NULL },
+		{ .opt = "V", .optAlternative = "control-variate",			.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isControlVariateEnabled },
+		{ .opt = "z", .optAlternative = "archive",				.hasArg = true, .foundArg = &sampleArchiveArg,				.foundOpt = NULL },
+		{ .opt = "Z", .optAlternative = "archive-precision",			.hasArg = true, .foundArg = &sampleArchivePrecisionArg,			.foundOpt = NULL },
+		{ .opt = "u", .optAlternative = "unpack",				.hasArg = true, .foundArg = &unpackArg,					.foundOpt = NULL },
+		{ .opt = "f", .optAlternative = "unpack-range",				.hasArg = true, .foundArg = &unpackRangeArg,				.foundOpt = NULL },
+		{ .opt = "e", .optAlternative = "decumulation-years",			.hasArg = true, .foundArg = &decumulationYearsArg,			.foundOpt = NULL },
+		{ .opt = "X", .optAlternative = "annual-withdrawal",			.hasArg = true, .foundArg = &annualWithdrawalArg,			.foundOpt = NULL },
+		{ .opt = "J", .optAlternative = "sobol-indices",			.hasArg = false, .foundArg = NULL,					.foundOpt = &arguments->isSobolIndicesModeEnabled },
 		{0},
 	};
 
@@ -343,10 +751,34 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 		return kCommonConstantReturnTypeError;
 	}
 
+	if (householdArg != NULL)
+	{
+		int	ret = snprintf(arguments->householdFilePath, kCommonConstantMaxCharsPerFilepath, "%s", householdArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the household accounts file from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Error: Household mode cannot read the input variables from a CSV file.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isHouseholdModeEnabled = true;
+	}
+
 	/*
 	 *	When all outputs are selected, we cannot be in benchmarking mode or Monte Carlo mode.
+	 *	Household mode has a single output (the household future value), and streaming mode
+	 *	reports summaries instead of samples, so they are exempt.
 	 */
-	if (arguments->common.outputSelect == kOutputDistributionIndexMax)
+	if ((arguments->common.outputSelect == kOutputDistributionIndexMax) && !arguments->isHouseholdModeEnabled && !arguments->isNdjsonModeEnabled)
 	{
 		if ((arguments->common.isBenchmarkingMode) || (arguments->common.isMonteCarloMode))
 		{
@@ -380,13 +812,31 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 		arguments->numberOfYearsToRetirement = value;
 	}
 
+	if (periodsPerYearArg != NULL)
+	{
+		int value;
+		int ret = parseIntChecked(periodsPerYearArg, &value);
+
+		if ((ret != kCommonConstantReturnTypeSuccess) || (value < 1))
+		{
+			fprintf(stderr, "Error: The number of periods per year must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->periodsPerYear = value;
+	}
+
 	if (compoundedAnnualInterestRateArg != NULL)
 	{
 		int	ret = snprintf(arguments->inputVariablesUxStrings[kInputDistributionIndexCompoundedAnnualInterestRate], kCommonConstantMaxCharsPerLine, "%s", compoundedAnnualInterestRateArg);
 
-		if (arguments->common.isMonteCarloMode)
+		if (strstr(compoundedAnnualInterestRateArg, kConstantStringUx) != NULL)
 		{
-			if (strstr(compoundedAnnualInterestRateArg, kConstantStringUx) != NULL)
+			distributionalArgumentGiven = true;
+
+			if (arguments->common.isMonteCarloMode)
 			{
 				fprintf(stderr, "Error: Native Monte Carlo is not compatible with Ux strings from command line.\n");
 
@@ -409,9 +859,11 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 	{
 		int	ret = snprintf(arguments->inputVariablesUxStrings[kInputDistributionIndexTotalAnnualContributionToAccount], kCommonConstantMaxCharsPerLine, "%s", totalAnnualContributionToAccountArg);
 
-		if (arguments->common.isMonteCarloMode)
+		if (strstr(totalAnnualContributionToAccountArg, kConstantStringUx) != NULL)
 		{
-			if (strstr(totalAnnualContributionToAccountArg, kConstantStringUx) != NULL)
+			distributionalArgumentGiven = true;
+
+			if (arguments->common.isMonteCarloMode)
 			{
 				fprintf(stderr, "Error: Native Monte Carlo is not compatible with Ux strings from command line.\n");
 
@@ -434,9 +886,11 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 	{
 		int	ret = snprintf(arguments->inputVariablesUxStrings[kInputDistributionIndexAssumedTaxRateOnInterest], kCommonConstantMaxCharsPerLine, "%s", assumedTaxRateOnInterestArg);
 
-		if (arguments->common.isMonteCarloMode)
+		if (strstr(assumedTaxRateOnInterestArg, kConstantStringUx) != NULL)
 		{
-			if (strstr(assumedTaxRateOnInterestArg, kConstantStringUx) != NULL)
+			distributionalArgumentGiven = true;
+
+			if (arguments->common.isMonteCarloMode)
 			{
 				fprintf(stderr, "Error: Native Monte Carlo is not compatible with Ux strings from command line.\n");
 
@@ -459,9 +913,11 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 	{
 		int	ret = snprintf(arguments->inputVariablesUxStrings[kInputDistributionIndexWithdrawalRate], kCommonConstantMaxCharsPerLine, "%s", withdrawalRateArg);
 
-		if (arguments->common.isMonteCarloMode)
+		if (strstr(withdrawalRateArg, kConstantStringUx) != NULL)
 		{
-			if (strstr(withdrawalRateArg, kConstantStringUx) != NULL)
+			distributionalArgumentGiven = true;
+
+			if (arguments->common.isMonteCarloMode)
 			{
 				fprintf(stderr, "Error: Native Monte Carlo is not compatible with Ux strings from command line.\n");
 
@@ -480,74 +936,973 @@ getCommandLineArguments(int argc, char *  argv[], CommandLineArguments *  argume
 		arguments->isInputVariableSet[kInputDistributionIndexWithdrawalRate] = true;
 	}
 
-	/*
-	 *	Monte Carlo mode does not work with command-line parameters.
-	 */
-	if (distributionalArgumentGiven && (arguments->common.isMonteCarloMode))
+	if (autocorrelationArg != NULL)
 	{
-		fprintf(stderr, "Error: Monte Carlo mode cannot work with distributional arguments.\n");
+		double	values[kInputDistributionIndexMax];
+		size_t	numberOfValues;
 
-		return kCommonConstantReturnTypeError;
+		if ((parseCommaSeparatedDoubles(autocorrelationArg, values, kInputDistributionIndexMax, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			((numberOfValues != 1) && (numberOfValues != kInputDistributionIndexMax)))
+		{
+			fprintf(stderr, "Error: The autocorrelation must be a single number or a comma-separated list of %d numbers.\n", kInputDistributionIndexMax);
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		for (size_t i = 0; i < kInputDistributionIndexMax; i++)
+		{
+			double	value = values[(numberOfValues == 1) ? 0 : i];
+
+			if ((value <= -1.0) || (value >= 1.0))
+			{
+				fprintf(stderr, "Error: The autocorrelation must be in the range (-1, 1).\n");
+
+				return kCommonConstantReturnTypeError;
+			}
+
+			arguments->inputCorrelation.autocorrelation[i] = value;
+		}
+
+		arguments->inputCorrelation.isEnabled = true;
 	}
 
-	/*
-	 *	We prioritize inputs given from CSV file.
-	 */
-	if (distributionalArgumentGiven && (arguments->common.isInputFromFileEnabled))
+	if (inputCorrelationsArg != NULL)
 	{
-		fprintf(stderr, "Warning: When reading data from an input file, input variable arguments are ignored.\n");
-	}
+		enum
+		{
+			kNumberOfCrossCorrelations = kInputDistributionIndexMax * (kInputDistributionIndexMax - 1) / 2,
+		};
+		double	values[kNumberOfCrossCorrelations];
+		size_t	numberOfValues;
+		size_t	k = 0;
+
+		if ((parseCommaSeparatedDoubles(inputCorrelationsArg, values, kNumberOfCrossCorrelations, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			(numberOfValues != kNumberOfCrossCorrelations))
+		{
+			fprintf(stderr, "Error: The input correlations must be a comma-separated list of %d numbers.\n", kNumberOfCrossCorrelations);
+			printUsage();
 
-	return kCommonConstantReturnTypeSuccess;
-}
+			return kCommonConstantReturnTypeError;
+		}
 
-void
-printHumanConsumableOutput(
-	CommandLineArguments *	arguments,
-	double *		outputDistributions,
-	const char *		outputVariableNames[kOutputDistributionIndexMax],
-	const char *		outputVariableDescriptions[kOutputDistributionIndexMax],
-	double *		monteCarloOutputSamples)
-{
-	OutputDistributionIndex	outputSelectLowerBound;
-	OutputDistributionIndex	outputSelectUpperBound;
+		for (int row = 0; row < kInputDistributionIndexMax; row++)
+		{
+			for (int column = row + 1; column < kInputDistributionIndexMax; column++)
+			{
+				if ((values[k] < -1.0) || (values[k] > 1.0))
+				{
+					fprintf(stderr, "Error: Input correlations must be in the range [-1, 1].\n");
 
-	determineIndexRangeOfSelectedOutputs(
-		arguments,
-		&outputSelectLowerBound,
-		&outputSelectUpperBound);
+					return kCommonConstantReturnTypeError;
+				}
 
-	for (OutputDistributionIndex outputSelect = outputSelectLowerBound; outputSelect < outputSelectUpperBound; outputSelect++)
+				arguments->inputCorrelation.crossCorrelation[row][column] = values[k];
+				arguments->inputCorrelation.crossCorrelation[column][row] = values[k];
+				k++;
+			}
+		}
+
+		arguments->inputCorrelation.isEnabled = true;
+	}
+
+	/*
+	 *	The Cholesky factor is computed once here, outside of the Monte Carlo loop.
+	 */
+	if (arguments->inputCorrelation.isEnabled)
 	{
-		/*
-		 *	If in Monte Carlo mode, `pointerToOutputVariable` points to the beginning of the `monteCarloOutputSamples` array.
-		 *	In this case, `arguments.common.numberOfMonteCarloIterations` is the length of the `monteCarloOutputSamples` array.
-		 *	Else, it points to the entry of the `outputDistributions` to be used.
-		 *	In this case, `arguments.common.numberOfMonteCarloIterations` equals 1.
-		 */
-		double *	pointerToValueToPrint = arguments->common.isMonteCarloMode ? monteCarloOutputSamples : &outputDistributions[outputSelect];
+		if (computeInputCorrelationCholeskyFactors(&arguments->inputCorrelation) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
 
-		for (size_t i = 0; i < arguments->common.numberOfMonteCarloIterations; ++i)
+		if (arguments->common.isInputFromFileEnabled)
 		{
-			printf("%s %s is $%.2lf.\n", outputVariableDescriptions[outputSelect], outputVariableNames[outputSelect], *pointerToValueToPrint);
-			pointerToValueToPrint++;
+			fprintf(stderr, "Warning: When reading data from an input file, input correlations are ignored.\n");
 		}
 	}
 
-	return;
-}
+	if (threadsArg != NULL)
+	{
+		int	value;
 
-void
-populateAndPrintJSONVariables(
-	CommandLineArguments *	arguments,
-	double *		inputVariables[kInputDistributionIndexMax],
-	const char *		inputVariableDescriptions[kOutputDistributionIndexMax],
-	double *		outputDistributions,
-	const char *		outputVariableDescriptions[kOutputDistributionIndexMax],
-	double *		monteCarloOutputSamples)
-{
-	JSONVariable		jsonVariables[kInputDistributionIndexMax + kOutputDistributionIndexMax];
-	OutputDistributionIndex	outputSelectLowerBound;
+		if ((parseIntChecked(threadsArg, &value) != kCommonConstantReturnTypeSuccess) || (value < 1))
+		{
+			fprintf(stderr, "Error: The number of threads must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->numberOfThreads = value;
+	}
+
+	if (arguments->numberOfThreads == 0)
+	{
+		long	numberOfProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+
+		arguments->numberOfThreads = (numberOfProcessors > 0) ? (int) numberOfProcessors : 1;
+	}
+
+	if (affinityArg != NULL)
+	{
+		if (strcmp(affinityArg, "none") == 0)
+		{
+			arguments->threadAffinity.policy = kThreadAffinityPolicyNone;
+		}
+		else if (strcmp(affinityArg, "compact") == 0)
+		{
+			arguments->threadAffinity.policy = kThreadAffinityPolicyCompact;
+		}
+		else if (strcmp(affinityArg, "scatter") == 0)
+		{
+			arguments->threadAffinity.policy = kThreadAffinityPolicyScatter;
+		}
+		else if (parseCpuList(affinityArg, arguments->threadAffinity.cpus, kThreadAffinityMaxNumberOfCpus, &arguments->threadAffinity.numberOfCpus) == kCommonConstantReturnTypeSuccess)
+		{
+			arguments->threadAffinity.policy = kThreadAffinityPolicyList;
+		}
+		else
+		{
+			fprintf(stderr, "Error: The affinity must be none, compact, scatter, or a list of CPUs such as 0,2,4-7.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if ((affinityArg != NULL) || arguments->isHugePagesEnabled)
+	{
+		if (!arguments->isParallelMonteCarloEnabled)
+		{
+			fprintf(stderr, "Error: Thread affinity and huge pages require NUMA-aware mode (-Q).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (arguments->isParallelMonteCarloEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: NUMA-aware mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((arguments->common.isInputFromFileEnabled && !arguments->inputBootstrap.isEnabled) || arguments->common.isOutputJSONMode || arguments->isHouseholdModeEnabled ||
+			arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled)
+		{
+			fprintf(stderr, "Error: NUMA-aware mode cannot be combined with inputs from a CSV file (except with -x), JSON output, household mode, importance sampling, goal-seek mode, or streaming mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (seedArg != NULL)
+	{
+		char *	end;
+
+		errno = 0;
+		arguments->seed = strtoull(seedArg, &end, 0);
+
+		if ((end == seedArg) || (*end != '\0') || (errno != 0))
+		{
+			fprintf(stderr, "Error: The seed must be an unsigned 64-bit integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (arguments->isNdjsonModeEnabled && (arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->common.isInputFromFileEnabled))
+	{
+		fprintf(stderr, "Error: Streaming mode cannot be combined with household mode, importance sampling, or inputs from a CSV file.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (referenceArg != NULL)
+	{
+		int	ret = snprintf(arguments->referenceFilePath, kCommonConstantMaxCharsPerFilepath, "%s", referenceArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the reference samples file from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isBenchmarkingMode || !arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: A reference distribution requires benchmarking mode (-b) and Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isReferenceSet = true;
+	}
+
+	/*
+	 *	Each account of a household draws its own contribution from the accounts file.
+	 */
+	if (arguments->isHouseholdModeEnabled)
+	{
+		bool	isContributionCorrelated = (arguments->inputCorrelation.autocorrelation[kInputDistributionIndexTotalAnnualContributionToAccount] != 0.0);
+
+		for (size_t j = 0; j < kInputDistributionIndexMax; j++)
+		{
+			if ((j != kInputDistributionIndexTotalAnnualContributionToAccount) &&
+				(arguments->inputCorrelation.crossCorrelation[kInputDistributionIndexTotalAnnualContributionToAccount][j] != 0.0))
+			{
+				isContributionCorrelated = true;
+			}
+		}
+
+		if (arguments->isReferenceSet)
+		{
+			fprintf(stderr, "Error: Household mode cannot be combined with a reference distribution (-R).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isInputVariableSet[kInputDistributionIndexTotalAnnualContributionToAccount])
+		{
+			fprintf(stderr, "Warning: In household mode, the total annual contribution argument is ignored.\n");
+		}
+
+		if (isContributionCorrelated)
+		{
+			fprintf(stderr, "Warning: In household mode, the correlations of the total annual contribution are ignored.\n");
+		}
+
+		if (numberOfYearsToRetirementArg != NULL)
+		{
+			fprintf(stderr, "Warning: In household mode, the number of years to retirement argument is ignored, as each account has its own.\n");
+		}
+	}
+
+	if (targetArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if (parseCommaSeparatedDoubles(targetArg, &arguments->shortfallTarget, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: The target future value must be a number.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isTargetSet = true;
+	}
+
+	if (arguments->isImportanceSamplingEnabled)
+	{
+		if (!arguments->isTargetSet || !arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Importance sampling requires a target (-g) and Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled || arguments->isHouseholdModeEnabled)
+		{
+			fprintf(stderr, "Error: Importance sampling only supports independent, default or constant inputs.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isReferenceSet)
+		{
+			fprintf(stderr, "Error: Importance sampling cannot be combined with a reference distribution (-R).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (confidenceArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(confidenceArg, &arguments->contributionConfidence, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->contributionConfidence > 0.0) || !(arguments->contributionConfidence < 1.0))
+		{
+			fprintf(stderr, "Error: The confidence must be a number in the range (0, 1).\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (arguments->isContributionSolverEnabled)
+	{
+		if (!arguments->isTargetSet || !arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Goal-seek mode requires a target (-g) and Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->isNdjsonModeEnabled)
+		{
+			fprintf(stderr, "Error: Goal-seek mode cannot be combined with inputs from a CSV file, household mode, importance sampling, or streaming mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isReferenceSet)
+		{
+			fprintf(stderr, "Error: Goal-seek mode cannot be combined with a reference distribution (-R).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isInputVariableSet[kInputDistributionIndexTotalAnnualContributionToAccount])
+		{
+			fprintf(stderr, "Warning: In goal-seek mode, the total annual contribution argument is ignored.\n");
+		}
+	}
+
+	if (timeBudgetArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(timeBudgetArg, &arguments->timeBudgetInMilliseconds, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->timeBudgetInMilliseconds > 0.0))
+		{
+			fprintf(stderr, "Error: The time budget must be a positive number of milliseconds.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: A time budget requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled || arguments->isParallelMonteCarloEnabled)
+		{
+			fprintf(stderr, "Error: A time budget cannot be combined with household mode, importance sampling, goal-seek mode, streaming mode, or NUMA-aware mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isTimeBudgetSet = true;
+	}
+
+	if (metricsFileArg != NULL)
+	{
+		int	ret = snprintf(arguments->metricsFilePath, kCommonConstantMaxCharsPerFilepath, "%s", metricsFileArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the metrics file from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isMetricsFileSet = true;
+	}
+
+	if (progressIntervalArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(progressIntervalArg, &arguments->progressIntervalInSeconds, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->progressIntervalInSeconds > 0.0))
+		{
+			fprintf(stderr, "Error: The progress interval must be a positive number of seconds.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->isMetricsFileSet && !arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: A progress interval requires a metrics file (-E) or progress on stderr (-D).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Progress metrics require Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled)
+		{
+			fprintf(stderr, "Error: Progress metrics cannot be combined with household mode, importance sampling, goal-seek mode, or streaming mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (blockLengthArg != NULL)
+	{
+		int	value;
+
+		if ((parseIntChecked(blockLengthArg, &value) != kCommonConstantReturnTypeSuccess) || (value < 1))
+		{
+			fprintf(stderr, "Error: The block length must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->inputBootstrap.isEnabled)
+		{
+			fprintf(stderr, "Error: A block length requires bootstrap mode (-x).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->inputBootstrap.blockLength = (size_t) value;
+	}
+
+	/*
+	 *	Bootstrap mode draws row indices, which needs samples rather than distributions.
+	 */
+	if (arguments->inputBootstrap.isEnabled)
+	{
+		if (!arguments->common.isInputFromFileEnabled || !arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Bootstrap mode requires an input CSV file and Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (loadInputBootstrapTable(arguments->common.inputFilePath, &arguments->inputBootstrap) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (chunkSizeArg != NULL)
+	{
+		int	value;
+
+		if ((parseIntChecked(chunkSizeArg, &value) != kCommonConstantReturnTypeSuccess) || (value < 1))
+		{
+			fprintf(stderr, "Error: The chunk size must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->isStreamOutputEnabled)
+		{
+			fprintf(stderr, "Error: A chunk size requires streamed output (-O).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->streamOutputChunkSize = (size_t) value;
+	}
+
+	if (arguments->isStreamOutputEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Streamed output requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isReferenceSet || arguments->isParallelMonteCarloEnabled || arguments->isHouseholdModeEnabled ||
+			arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled)
+		{
+			fprintf(stderr, "Error: Streamed output cannot be combined with JSON output, a reference distribution, NUMA-aware mode, household mode, importance sampling, goal-seek mode, or streaming mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (checkpointArg != NULL)
+	{
+		int	ret = snprintf(arguments->checkpointFilePath, kCommonConstantMaxCharsPerFilepath, "%s", checkpointArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the checkpoint file from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isCheckpointEnabled = true;
+	}
+
+	if (checkpointIntervalArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(checkpointIntervalArg, &arguments->checkpointIntervalInSeconds, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->checkpointIntervalInSeconds > 0.0))
+		{
+			fprintf(stderr, "Error: The checkpoint interval must be a positive number of seconds.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (((checkpointIntervalArg != NULL) || arguments->isResumeEnabled) && !arguments->isCheckpointEnabled)
+	{
+		fprintf(stderr, "Error: A checkpoint interval or resuming requires a checkpoint file (-k).\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Checkpointed runs draw from the sampling streams of NUMA-aware mode, in a single loop whose
+	 *	length must not depend on time.
+	 */
+	if (arguments->isCheckpointEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Checkpoints require Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isParallelMonteCarloEnabled || arguments->isTimeBudgetSet || arguments->isStreamOutputEnabled || arguments->isHouseholdModeEnabled ||
+			arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled)
+		{
+			fprintf(stderr, "Error: Checkpoints cannot be combined with NUMA-aware mode, a time budget, streamed output, household mode, importance sampling, goal-seek mode, or streaming mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (sampleArchiveArg != NULL)
+	{
+		int	ret = snprintf(arguments->sampleArchiveFilePath, kCommonConstantMaxCharsPerFilepath, "%s", sampleArchiveArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the sample archive from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isSampleArchiveEnabled = true;
+	}
+
+	if (sampleArchivePrecisionArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(sampleArchivePrecisionArg, &arguments->sampleArchiveQuantum, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->sampleArchiveQuantum > 0.0))
+		{
+			fprintf(stderr, "Error: The precision of the sample archive must be a positive number.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->isSampleArchiveEnabled)
+		{
+			fprintf(stderr, "Error: A precision of the sample archive requires a sample archive (-z).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	The archive is written from the samples in memory, at the end of the main Monte Carlo loop.
+	 */
+	if (arguments->isSampleArchiveEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: A sample archive requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isStreamOutputEnabled || arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled ||
+			arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled || (compareArg != NULL) || arguments->isControlVariateEnabled)
+		{
+			fprintf(stderr, "Error: A sample archive cannot be combined with streamed output, household mode, importance sampling, goal-seek mode, streaming mode, comparison mode, or control-variate mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (unpackArg != NULL)
+	{
+		int	ret = snprintf(arguments->unpackFilePath, kCommonConstantMaxCharsPerFilepath, "%s", unpackArg);
+
+		if ((ret < 0) || (ret >= kCommonConstantMaxCharsPerFilepath))
+		{
+			fprintf(stderr, "Error: Could not read the path of the sample archive to unpack from command-line arguments.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isMonteCarloMode || arguments->isSampleArchiveEnabled)
+		{
+			fprintf(stderr, "Error: Unpack mode reads an archive and does not run the model, so it cannot be combined with Monte Carlo mode (-M) or a sample archive (-z).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isUnpackModeEnabled = true;
+	}
+
+	if (unpackRangeArg != NULL)
+	{
+		double	range[2];
+		size_t	numberOfValues;
+
+		/*
+		 *	Ranks are integers below 2^53, so that doubles hold them exactly.
+		 */
+		if ((parseCommaSeparatedDoubles(unpackRangeArg, range, 2, &numberOfValues) != kCommonConstantReturnTypeSuccess) || (numberOfValues != 2) ||
+			!(range[0] >= 0.0) || !(range[1] >= 0.0) || (range[0] != floor(range[0])) || (range[1] != floor(range[1])) ||
+			(range[0] >= 9007199254740992.0) || (range[1] >= 9007199254740992.0))
+		{
+			fprintf(stderr, "Error: The unpack range must be a comma-separated pair of a first rank and a number of samples, both non-negative integers.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->isUnpackModeEnabled)
+		{
+			fprintf(stderr, "Error: An unpack range requires unpack mode (-u).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isUnpackRangeSet = true;
+		arguments->unpackRangeFirstSample = (uint64_t) range[0];
+		arguments->unpackRangeNumberOfSamples = (uint64_t) range[1];
+	}
+
+	if (compareArg != NULL)
+	{
+		CommandLineArguments *	argumentsB;
+		CommonConstantReturnType	ret;
+
+		if (snprintf(arguments->scenarioSpecification, kCommonConstantMaxCharsPerLine, "%s", compareArg) >= kCommonConstantMaxCharsPerLine)
+		{
+			fprintf(stderr, "Error: The specification of scenario B is too long.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	Check the specification on a scratch copy of the arguments.
+		 */
+		argumentsB = (CommandLineArguments *) checkedMalloc(sizeof(CommandLineArguments), __FILE__, __LINE__);
+		*argumentsB = *arguments;
+		ret = applyScenarioSpecification(argumentsB, compareArg);
+		free(argumentsB);
+
+		if (ret != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(stderr, "Error: The specification of scenario B must be a comma-separated list of key=value, with keys t, c, r, w (constant inputs), m (periods per year), and S (output).\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Comparison mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isReferenceSet || arguments->isParallelMonteCarloEnabled || arguments->isTimeBudgetSet ||
+			arguments->isStreamOutputEnabled || arguments->isCheckpointEnabled || arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled ||
+			arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled || arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: Comparison mode cannot be combined with JSON output, a reference distribution, NUMA-aware mode, a time budget, streamed output, checkpoints, household mode, importance sampling, goal-seek mode, streaming mode, or progress metrics.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isScenarioComparisonEnabled = true;
+	}
+
+	/*
+	 *	Control-variate mode needs the exact moments of independent, default or constant inputs.
+	 */
+	if (arguments->isControlVariateEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Control-variate mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled || arguments->inputBootstrap.isEnabled ||
+			distributionalArgumentGiven || (arguments->periodsPerYear != 1))
+		{
+			fprintf(stderr, "Error: Control-variate mode requires independent, default or constant inputs and annual compounding.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	The control variate is the future value at the averages of the inputs over the years.
+		 */
+		if (arguments->numberOfYearsToRetirement < 1)
+		{
+			fprintf(stderr, "Error: Control-variate mode requires at least one year to retirement (-n).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isReferenceSet || arguments->isParallelMonteCarloEnabled || arguments->isTimeBudgetSet ||
+			arguments->isStreamOutputEnabled || arguments->isCheckpointEnabled || arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled ||
+			arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled || arguments->isScenarioComparisonEnabled ||
+			arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: Control-variate mode cannot be combined with JSON output, a reference distribution, NUMA-aware mode, a time budget, streamed output, checkpoints, household mode, importance sampling, goal-seek mode, streaming mode, comparison mode, or progress metrics.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (decumulationYearsArg != NULL)
+	{
+		int	value;
+
+		if ((parseIntChecked(decumulationYearsArg, &value) != kCommonConstantReturnTypeSuccess) || (value < 1))
+		{
+			fprintf(stderr, "Error: The number of years of retirement must be a positive integer.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isDecumulationEnabled = true;
+		arguments->decumulationYears = value;
+	}
+
+	if (annualWithdrawalArg != NULL)
+	{
+		size_t	numberOfValues;
+
+		if ((parseCommaSeparatedDoubles(annualWithdrawalArg, &arguments->decumulationWithdrawal, 1, &numberOfValues) != kCommonConstantReturnTypeSuccess) ||
+			!(arguments->decumulationWithdrawal >= 0.0))
+		{
+			fprintf(stderr, "Error: The annual withdrawal must be a non-negative number.\n");
+			printUsage();
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->isDecumulationEnabled)
+		{
+			fprintf(stderr, "Error: An annual withdrawal requires decumulation mode (-e).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isDecumulationWithdrawalSet = true;
+	}
+
+	/*
+	 *	Decumulation mode draws the years of retirement from the sampling streams of NUMA-aware
+	 *	mode, with independent, default or constant inputs.
+	 */
+	if (arguments->isDecumulationEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Decumulation mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled || arguments->inputBootstrap.isEnabled || distributionalArgumentGiven)
+		{
+			fprintf(stderr, "Error: Decumulation mode requires independent, default or constant inputs.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isReferenceSet || arguments->isParallelMonteCarloEnabled || arguments->isTimeBudgetSet ||
+			arguments->isStreamOutputEnabled || arguments->isCheckpointEnabled || arguments->isSampleArchiveEnabled || arguments->isHouseholdModeEnabled ||
+			arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled || arguments->isNdjsonModeEnabled ||
+			arguments->isScenarioComparisonEnabled || arguments->isControlVariateEnabled || arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: Decumulation mode cannot be combined with JSON output, a reference distribution, NUMA-aware mode, a time budget, streamed output, checkpoints, a sample archive, household mode, importance sampling, goal-seek mode, streaming mode, comparison mode, control-variate mode, or progress metrics.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	Sobol indices are defined for independent inputs, and each input is a group of per-year values.
+	 */
+	if (arguments->isSobolIndicesModeEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Sensitivity mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled || arguments->inputBootstrap.isEnabled || distributionalArgumentGiven)
+		{
+			fprintf(stderr, "Error: Sensitivity mode requires independent, default or constant inputs.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isReferenceSet || arguments->isParallelMonteCarloEnabled || arguments->isTimeBudgetSet ||
+			arguments->isStreamOutputEnabled || arguments->isCheckpointEnabled || arguments->isSampleArchiveEnabled || arguments->isFusedKernelEnabled ||
+			arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled ||
+			arguments->isNdjsonModeEnabled || arguments->isScenarioComparisonEnabled || arguments->isControlVariateEnabled || arguments->isDecumulationEnabled ||
+			arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: Sensitivity mode cannot be combined with JSON output, a reference distribution, NUMA-aware mode, a time budget, streamed output, checkpoints, a sample archive, fused mode, household mode, importance sampling, goal-seek mode, streaming mode, comparison mode, control-variate mode, decumulation mode, or progress metrics.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	The fused kernel draws independent, default or constant inputs, and compounds annually.
+	 */
+	if (arguments->isFusedKernelEnabled)
+	{
+		if (!arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "Error: Fused mode requires Monte Carlo mode (-M).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled || arguments->inputBootstrap.isEnabled ||
+			distributionalArgumentGiven || (arguments->periodsPerYear != 1))
+		{
+			fprintf(stderr, "Error: Fused mode requires independent, default or constant inputs and annual compounding.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->isHouseholdModeEnabled || arguments->isImportanceSamplingEnabled || arguments->isContributionSolverEnabled ||
+			arguments->isNdjsonModeEnabled || arguments->isScenarioComparisonEnabled || arguments->isControlVariateEnabled)
+		{
+			fprintf(stderr, "Error: Fused mode cannot be combined with household mode, importance sampling, goal-seek mode, streaming mode, comparison mode, or control-variate mode.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	Moments mode propagates the moments of independent, default or constant inputs.
+	 */
+	if (arguments->isMomentsModeEnabled)
+	{
+		if (arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled || arguments->inputCorrelation.isEnabled ||
+			distributionalArgumentGiven || (arguments->periodsPerYear != 1))
+		{
+			fprintf(stderr, "Error: Moments mode does not sample (-M), and requires independent, default or constant inputs and annual compounding.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->common.isOutputJSONMode || arguments->isHouseholdModeEnabled || arguments->isNdjsonModeEnabled ||
+			arguments->isMetricsFileSet || arguments->isProgressToStderrEnabled)
+		{
+			fprintf(stderr, "Error: Moments mode cannot be combined with JSON output, household mode, streaming mode, or progress metrics.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	Monte Carlo mode does not work with command-line parameters.
+	 */
+	if (distributionalArgumentGiven && (arguments->common.isMonteCarloMode))
+	{
+		fprintf(stderr, "Error: Monte Carlo mode cannot work with distributional arguments.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	We prioritize inputs given from CSV file.
+	 */
+	if (distributionalArgumentGiven && (arguments->common.isInputFromFileEnabled))
+	{
+		fprintf(stderr, "Warning: When reading data from an input file, input variable arguments are ignored.\n");
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+printHumanConsumableOutput(
+	CommandLineArguments *	arguments,
+	double *		outputDistributions,
+	const char *		outputVariableNames[kOutputDistributionIndexMax],
+	const char *		outputVariableDescriptions[kOutputDistributionIndexMax],
+	double *		monteCarloOutputSamples)
+{
+	OutputDistributionIndex	outputSelectLowerBound;
+	OutputDistributionIndex	outputSelectUpperBound;
+
+	determineIndexRangeOfSelectedOutputs(
+		arguments,
+		&outputSelectLowerBound,
+		&outputSelectUpperBound);
+
+	for (OutputDistributionIndex outputSelect = outputSelectLowerBound; outputSelect < outputSelectUpperBound; outputSelect++)
+	{
+		/*
+		 *	If in Monte Carlo mode, `pointerToOutputVariable` points to the beginning of the `monteCarloOutputSamples` array.
+		 *	In this case, `arguments.common.numberOfMonteCarloIterations` is the length of the `monteCarloOutputSamples` array.
+		 *	Else, it points to the entry of the `outputDistributions` to be used.
+		 *	In this case, `arguments.common.numberOfMonteCarloIterations` equals 1.
+		 */
+		double *	pointerToValueToPrint = arguments->common.isMonteCarloMode ? monteCarloOutputSamples : &outputDistributions[outputSelect];
+
+		for (size_t i = 0; i < arguments->common.numberOfMonteCarloIterations; ++i)
+		{
+			printf("%s %s is $%.2lf.\n", outputVariableDescriptions[outputSelect], outputVariableNames[outputSelect], *pointerToValueToPrint);
+			pointerToValueToPrint++;
+		}
+	}
+
+	return;
+}
+
+void
+populateAndPrintJSONVariables(
+	CommandLineArguments *	arguments,
+	double *		inputVariables[kInputDistributionIndexMax],
+	const char *		inputVariableDescriptions[kOutputDistributionIndexMax],
+	double *		outputDistributions,
+	const char *		outputVariableDescriptions[kOutputDistributionIndexMax],
+	double *		monteCarloOutputSamples)
+{
+	JSONVariable		jsonVariables[kInputDistributionIndexMax + kOutputDistributionIndexMax];
+	OutputDistributionIndex	outputSelectLowerBound;
 	OutputDistributionIndex	outputSelectUpperBound;
 	size_t 			jsonVariableIndex = 0;
 
@@ -592,19 +1947,70 @@ populateAndPrintJSONVariables(
 	return;
 }
 
+void
+prepareOutputVariableDescriptions(
+	CommandLineArguments *	arguments,
+	char			outputVariableDescriptionStrings[kOutputDistributionIndexMax][kCommonConstantMaxCharsPerLine],
+	const char *		outputVariableDescriptions[kOutputDistributionIndexMax])
+{
+	const char *	compounding = NULL;
+
+	switch (arguments->periodsPerYear)
+	{
+		case 1:
+			compounding = "annually";
+			break;
+		case 2:
+			compounding = "semi-annually";
+			break;
+		case 4:
+			compounding = "quarterly";
+			break;
+		case 12:
+			compounding = "monthly";
+			break;
+		case 52:
+			compounding = "weekly";
+			break;
+		case 365:
+			compounding = "daily";
+			break;
+		default:
+			break;
+	}
+
+	for (size_t i = 0; i < kOutputDistributionIndexMax; i++)
+	{
+		if (compounding != NULL)
+		{
+			snprintf(
+				outputVariableDescriptionStrings[i],
+				kCommonConstantMaxCharsPerLine,
+				"%s (compounded %s)",
+				kOutputVariableDescriptionPrefixes[i],
+				compounding);
+		}
+		else
+		{
+			snprintf(
+				outputVariableDescriptionStrings[i],
+				kCommonConstantMaxCharsPerLine,
+				"%s (compounded %d times per year)",
+				kOutputVariableDescriptionPrefixes[i],
+				arguments->periodsPerYear);
+		}
+
+		outputVariableDescriptions[i] = outputVariableDescriptionStrings[i];
+	}
+
+	return;
+}
+
 CommonConstantReturnType
 prepareCSVInputVariables(
 	CommandLineArguments *	arguments,
 	double *		CSVInputVariables[kInputDistributionIndexMax])
 {
-	const char *		inputCSVHeaders[] =
-				{
-					"total_annual_contribution",
-					"compounded_annual_interest_percentage",
-					"withdrawal_rate_percentage",
-					"assumed_tax_rate_on_interest_percentage"
-				};
-
 	int numberOfYearsToRetirement = arguments->numberOfYearsToRetirement;
 
 	for (size_t i = 0; i < numberOfYearsToRetirement; i++)
@@ -614,7 +2020,7 @@ prepareCSVInputVariables(
 
 		ret = readInputDoubleDistributionsFromCSV(
 				arguments->common.inputFilePath,
-				inputCSVHeaders,
+				kInputCSVHeaders,
 				tempInputVariables,
 				kInputDistributionIndexMax);
 
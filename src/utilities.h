@@ -26,6 +26,7 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include "common.h"
+#include "sampling.h"
 
 
 #define kDefaultInputDistributionConstantAnnualInterestRateMin	(0.5)
@@ -36,10 +37,17 @@
 #define kDefaultInputDistributionConstantTaxRateInterestMax	(40.0)
 #define kDefaultInputDistributionConstantWithdrawalRateMin	(20.0)
 #define kDefaultInputDistributionConstantWithdrawalRateMax	(40.0)
+#define kDefaultContributionConfidence				(0.9)
+#define kDefaultProgressIntervalInSeconds			(1.0)
+#define kDefaultCheckpointIntervalInSeconds			(60.0)
+#define kDefaultSampleArchiveQuantum				(0.01)
+#define kDefaultDecumulationWithdrawalPercentage		(4.0)
 
 typedef enum
 {
 	kDemoFinanceIraDefaultNumberOfYearsToRetirement = 20,
+	kDemoFinanceIraDefaultPeriodsPerYear = 1,
+	kDemoFinanceIraDefaultStreamOutputChunkSize = 65536,
 } DemoFinanceIraDefault;
 
 typedef enum
@@ -58,16 +66,139 @@ typedef enum
 	kOutputDistributionIndexMax				= 2
 } OutputDistributionIndex;
 
+enum
+{
+	/*
+	 *	Number of subsets of the inputs, as bit masks indexed by `InputDistributionIndex`.
+	 */
+	kInputCorrelationNumberOfFreeInputSets = 1 << kInputDistributionIndexMax,
+};
+
+typedef struct
+{
+	bool	isEnabled;
+	double	autocorrelation[kInputDistributionIndexMax];
+	double	crossCorrelation[kInputDistributionIndexMax][kInputDistributionIndexMax];
+	/*
+	 *	Cholesky factors of the correlation matrix of the yearly innovations of the AR(1)
+	 *	processes, and the transforms from draws correlated by them to draws correlated by the
+	 *	factor of `crossCorrelation`, for the first year. Both are indexed by the bit mask of the
+	 *	inputs that are sampled rather than set from the command line, with the rows and columns
+	 *	of the other inputs set to the identity.
+	 */
+	double	choleskyFactors[kInputCorrelationNumberOfFreeInputSets][kInputDistributionIndexMax][kInputDistributionIndexMax];
+	double	initialStateTransforms[kInputCorrelationNumberOfFreeInputSets][kInputDistributionIndexMax][kInputDistributionIndexMax];
+} InputCorrelation;
+
+/**
+ *	Rows of the input CSV file for bootstrap resampling, stored as a structure of arrays indexed
+ *	by row, with the Walker alias table of the row weights if the file has a `weight` column.
+ */
+typedef struct
+{
+	bool		isEnabled;
+	size_t		blockLength;
+	size_t		numberOfRows;
+	double *	columns[kInputDistributionIndexMax];
+	bool		isWeighted;
+	double *	aliasProbability;
+	uint32_t *	aliasIndex;
+} InputBootstrap;
+
+typedef enum
+{
+	kThreadAffinityPolicyNone	= 0,
+	kThreadAffinityPolicyCompact	= 1,
+	kThreadAffinityPolicyScatter	= 2,
+	kThreadAffinityPolicyList	= 3,
+} ThreadAffinityPolicy;
+
+enum
+{
+	kThreadAffinityMaxNumberOfCpus = 1024,
+};
+
+typedef struct
+{
+	ThreadAffinityPolicy	policy;
+	int			cpus[kThreadAffinityMaxNumberOfCpus];
+	size_t			numberOfCpus;
+} ThreadAffinity;
+
 typedef struct
 {
 	CommonCommandLineArguments	common;
 
 	int				numberOfYearsToRetirement;
+	int				periodsPerYear;
 	char				inputVariablesUxStrings[kInputDistributionIndexMax][kCommonConstantMaxCharsPerLine];
 	bool				isInputVariableSet[kInputDistributionIndexMax];
+	InputCorrelation		inputCorrelation;
+	InputBootstrap			inputBootstrap;
+	bool				isHouseholdModeEnabled;
+	char				householdFilePath[kCommonConstantMaxCharsPerFilepath];
+	bool				isImportanceSamplingEnabled;
+	bool				isTargetSet;
+	double				shortfallTarget;
+	bool				isContributionSolverEnabled;
+	double				contributionConfidence;
+	bool				isNdjsonModeEnabled;
+	bool				isMomentsModeEnabled;
+	bool				isScenarioComparisonEnabled;
+	char				scenarioSpecification[kCommonConstantMaxCharsPerLine];
+	bool				isControlVariateEnabled;
+	bool				isFusedKernelEnabled;
+	bool				isDecumulationEnabled;
+	int				decumulationYears;
+	bool				isDecumulationWithdrawalSet;
+	double				decumulationWithdrawal;
+	bool				isSobolIndicesModeEnabled;
+	int				numberOfThreads;
+	bool				isParallelMonteCarloEnabled;
+	ThreadAffinity			threadAffinity;
+	bool				isHugePagesEnabled;
+	uint64_t			seed;
+	bool				isMetricsFileSet;
+	char				metricsFilePath[kCommonConstantMaxCharsPerFilepath];
+	bool				isProgressToStderrEnabled;
+	double				progressIntervalInSeconds;
+	bool				isStreamOutputEnabled;
+	size_t				streamOutputChunkSize;
+	bool				isCheckpointEnabled;
+	char				checkpointFilePath[kCommonConstantMaxCharsPerFilepath];
+	double				checkpointIntervalInSeconds;
+	bool				isResumeEnabled;
+	bool				isSampleArchiveEnabled;
+	char				sampleArchiveFilePath[kCommonConstantMaxCharsPerFilepath];
+	double				sampleArchiveQuantum;
+	bool				isUnpackModeEnabled;
+	char				unpackFilePath[kCommonConstantMaxCharsPerFilepath];
+	bool				isUnpackRangeSet;
+	uint64_t			unpackRangeFirstSample;
+	uint64_t			unpackRangeNumberOfSamples;
+	bool				isTimeBudgetSet;
+	double				timeBudgetInMilliseconds;
+	bool				isReferenceSet;
+	char				referenceFilePath[kCommonConstantMaxCharsPerFilepath];
 
 } CommandLineArguments;
 
+/**
+ *	Bounds of the default uniform input distributions, indexed by `InputDistributionIndex`.
+ */
+extern const double	kDefaultInputDistributionMin[kInputDistributionIndexMax];
+extern const double	kDefaultInputDistributionMax[kInputDistributionIndexMax];
+
+/**
+ *	Names of the output variables, indexed by `OutputDistributionIndex`.
+ */
+extern const char *	kOutputVariableNames[kOutputDistributionIndexMax];
+
+/**
+ *	Headers of the input columns of the input CSV file, indexed by `InputDistributionIndex`.
+ */
+extern const char *	kInputCSVHeaders[kInputDistributionIndexMax];
+
 /**
  *	@brief	Print out command-line usage.
  */
@@ -96,6 +227,38 @@ void	setInputVariables(
 		CommandLineArguments *	arguments,
 		double *		inputVariables[kInputDistributionIndexMax]);
 
+/**
+ *	@brief	Set input variables like `setInputVariables()`, drawing samples from a sampling stream.
+ *
+ *	Unlike UxHw calls in native execution, this is safe to call concurrently from several
+ *	threads, as long as each uses its own stream.
+ *
+ *	@param	arguments			: Pointer to command-line arguments struct.
+ *	@param	stream				: Sampling stream, or `NULL` to use UxHw calls.
+ *	@param	inputVariables			: The input variables to be set.
+ */
+void	setInputVariablesFromStream(
+		CommandLineArguments *	arguments,
+		SamplingStream *	stream,
+		double *		inputVariables[kInputDistributionIndexMax]);
+
+/**
+ *	@brief	Set the input variables of several consecutive paths from a sampling stream.
+ *
+ *	Draws the same samples as calling `setInputVariablesFromStream()` once per path, but lets the
+ *	correlated sampler work on all paths at once.
+ *
+ *	@param	arguments			: Pointer to command-line arguments struct.
+ *	@param	stream				: Sampling stream, or `NULL` to use UxHw calls.
+ *	@param	numberOfPaths			: Number of paths.
+ *	@param	inputVariables			: The input variables to be set, holding `numberOfYearsToRetirement` years of each path in turn.
+ */
+void	setInputVariablesBatchFromStream(
+		CommandLineArguments *	arguments,
+		SamplingStream *	stream,
+		size_t			numberOfPaths,
+		double *		inputVariables[kInputDistributionIndexMax]);
+
 
 /**
  *	@brief	Determine the index range of selected outputs.
@@ -142,6 +305,18 @@ void	populateAndPrintJSONVariables(
 		const char *		outputVariableDescriptions[kOutputDistributionIndexMax],
 		double *		monteCarloOutputSamples);
 
+/**
+ *	@brief	Prepare the descriptions of the output variables, which state the compounding frequency.
+ *
+ *	@param	arguments				: Pointer to command-line arguments struct.
+ *	@param	outputVariableDescriptionStrings	: Storage for the descriptions.
+ *	@param	outputVariableDescriptions		: The descriptions to be set, pointing into `outputVariableDescriptionStrings`.
+ */
+void	prepareOutputVariableDescriptions(
+		CommandLineArguments *	arguments,
+		char			outputVariableDescriptionStrings[kOutputDistributionIndexMax][kCommonConstantMaxCharsPerLine],
+		const char *		outputVariableDescriptions[kOutputDistributionIndexMax]);
+
 /**
  *	@brief	Read the input variables from a CSV file.
  *
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+"""
+Cross-check of moments mode (`-U`) against Monte Carlo mode (`-M`).
+
+Moments mode propagates the exact mean and variance of the inputs through the model. For each
+scenario of a fixed set, the check runs moments mode and a Monte Carlo run with streamed output
+(`-O`), which prints the mean and standard deviation of its samples, and compares them: the Monte
+Carlo mean must be within `--z` standard errors of the exact mean, and the Monte Carlo standard
+deviation within a relative `--tolerance` of the exact one. Moments mode must also reject inputs
+given as Ux strings, which have no moments to propagate. The check exits with a non-zero status on
+any mismatch.
+"""
+
+import argparse
+import math
+import os
+import re
+import subprocess
+import sys
+
+
+#
+#	The fixed set of scenarios, without the number of iterations, seed and mode arguments.
+#
+kScenarios = {
+	"default-n20-S0":	["-n", "20", "-S", "0"],
+	"default-n20-S1":	["-n", "20", "-S", "1"],
+	"default-n40-S0":	["-n", "40", "-S", "0"],
+	"t8000-n20-S0":		["-t", "8000", "-n", "20", "-S", "0"],
+	"c3-n30-S1":		["-c", "3", "-n", "30", "-S", "1"],
+}
+
+#
+#	Scenarios that moments mode must reject, one per input given as a Ux string.
+#
+kRejectedScenarios = {
+	"ux-t":			["-n", "20", "-S", "0", "-t", "8000Ux0000"],
+	"ux-c":			["-n", "20", "-S", "0", "-c", "5Ux0000"],
+	"ux-r":			["-n", "20", "-S", "0", "-r", "0.2Ux0000"],
+	"ux-w":			["-n", "20", "-S", "0", "-w", "0.04Ux0000"],
+}
+kMomentsPattern = re.compile(r"mean \$([-0-9.]+), standard deviation \$([-0-9.]+)")
+
+
+def run(command, workingDirectory):
+	"""Run the executable and return the mean and standard deviation that it prints."""
+	result = subprocess.run(command, cwd=workingDirectory, capture_output=True, text=True, check=False)
+
+	if result.returncode != 0:
+		raise RuntimeError(f"`{' '.join(command)}` failed with exit code {result.returncode}: {result.stderr.strip()}")
+
+	match = kMomentsPattern.search(result.stdout)
+
+	if match is None:
+		raise RuntimeError(f"`{' '.join(command)}` printed an unexpected line: {result.stdout.strip()!r}")
+
+	return float(match.group(1)), float(match.group(2))
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("executable", help="Path to the native executable (e.g., src/native-exe).")
+	parser.add_argument("--iterations", type=int, default=200000, help="Monte Carlo iterations per run (-M).")
+	parser.add_argument("--seed", type=int, default=1, help="Seed of the Monte Carlo runs (-s).")
+	parser.add_argument("--z", type=float, default=5.0, help="Standard errors by which the Monte Carlo mean may differ from the exact mean.")
+	parser.add_argument("--tolerance", type=float, default=0.02, help="Relative difference of the standard deviations that fails the check.")
+	arguments = parser.parse_args()
+
+	executable = os.path.abspath(arguments.executable)
+	workingDirectory = os.path.dirname(executable)
+	failed = False
+
+	print(f"{'scenario':<16} {'exact mean':>12} {'MC mean':>12} {'z':>7} {'exact sd':>10} {'MC sd':>10} {'change':>8}  verdict")
+
+	for name, scenarioArguments in kScenarios.items():
+		exactMean, exactStandardDeviation = run([executable] + scenarioArguments + ["-U"], workingDirectory)
+		monteCarloMean, monteCarloStandardDeviation = run(
+			[executable] + scenarioArguments + ["-M", str(arguments.iterations), "-s", str(arguments.seed), "-O"],
+			workingDirectory)
+		standardError = exactStandardDeviation / math.sqrt(arguments.iterations)
+		z = (monteCarloMean - exactMean) / standardError if standardError > 0.0 else 0.0
+		change = monteCarloStandardDeviation / exactStandardDeviation - 1.0 if exactStandardDeviation > 0.0 else 0.0
+		isMismatch = (abs(z) > arguments.z) or (abs(change) > arguments.tolerance)
+		failed = failed or isMismatch
+
+		print(
+			f"{name:<16} {exactMean:>12.2f} {monteCarloMean:>12.2f} {z:>+7.2f} {exactStandardDeviation:>10.2f} "
+			f"{monteCarloStandardDeviation:>10.2f} {change:>+8.2%}  {'MISMATCH' if isMismatch else 'ok'}")
+
+	for name, scenarioArguments in kRejectedScenarios.items():
+		command = [executable] + scenarioArguments + ["-U"]
+		result = subprocess.run(command, cwd=workingDirectory, capture_output=True, text=True, check=False)
+		isMismatch = (result.returncode == 0)
+		failed = failed or isMismatch
+
+		print(f"{name:<16} {'rejected' if not isMismatch else 'accepted':>12}  {'MISMATCH' if isMismatch else 'ok'}")
+
+	return 1 if failed else 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+"""
+Cross-check of scenario comparison mode (`-d`) against plain Monte Carlo runs.
+
+Scenario A of a comparison is the scenario of the command line, and draws its inputs from the
+same seed (`-s`) as a plain run, so the mean of scenario A must equal the mean that the plain run
+reports in benchmarking mode (`-b`). The check runs both, with default inputs and with the inputs
+of `inputs/Finance-IRA-inputs.csv` (`-i`), and exits with a non-zero status on any mismatch.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+
+kRepositoryRoot = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+kCSVInputPath = os.path.join(kRepositoryRoot, "inputs", "Finance-IRA-inputs.csv")
+
+#
+#	The fixed set of scenarios, without the number of iterations, seed and mode arguments.
+#
+kScenarios = {
+	"default-n20":		["-n", "20", "-S", "0"],
+	"default-n20-S1":	["-n", "20", "-S", "1"],
+	"csv-n20":		["-i", kCSVInputPath, "-n", "20", "-S", "0"],
+	"csv-n40-S1":		["-i", kCSVInputPath, "-n", "40", "-S", "1"],
+}
+kScenarioB = "c=7"
+kTolerance = 0.01
+
+
+def run(command, workingDirectory):
+	"""Run the executable and return its standard output."""
+	result = subprocess.run(command, cwd=workingDirectory, capture_output=True, text=True, check=False)
+
+	if result.returncode != 0:
+		raise RuntimeError(f"`{' '.join(command)}` failed with exit code {result.returncode}: {result.stderr.strip()}")
+
+	return result.stdout
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("executable", help="Path to the native executable (e.g., src/native-exe).")
+	parser.add_argument("--iterations", type=int, default=20000, help="Monte Carlo iterations per run (-M).")
+	parser.add_argument("--seed", type=int, default=1, help="Seed of the runs (-s).")
+	arguments = parser.parse_args()
+
+	executable = os.path.abspath(arguments.executable)
+	workingDirectory = os.path.dirname(executable)
+	common = ["-M", str(arguments.iterations), "-s", str(arguments.seed)]
+	failed = False
+
+	print(f"{'scenario':<16} {'plain mean':>16} {'scenario A mean':>16}  verdict")
+
+	for name, scenarioArguments in kScenarios.items():
+		plainOutput = run([executable] + scenarioArguments + common + ["-b"], workingDirectory)
+		comparisonOutput = run([executable] + scenarioArguments + common + ["-d", kScenarioB], workingDirectory)
+		plainMean = float(plainOutput.split()[0])
+		match = re.search(r"^Scenario A \([^)]*\): mean \$(\S+)\.$", comparisonOutput, re.MULTILINE)
+
+		if match is None:
+			print(f"Error: Unexpected output of comparison mode for scenario \"{name}\": {comparisonOutput.strip()!r}", file=sys.stderr)
+
+			return 2
+
+		scenarioAMean = float(match.group(1))
+		isMismatch = abs(scenarioAMean - plainMean) > kTolerance
+		failed = failed or isMismatch
+
+		print(f"{name:<16} {plainMean:>16.2f} {scenarioAMean:>16.2f}  {'MISMATCH' if isMismatch else 'ok'}")
+
+	return 1 if failed else 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())